@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "AllocationCounter.h"
+
+#ifdef DAE_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> g_AllocationCount{};
+
+	void* CountedAllocate(std::size_t size)
+	{
+		g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (size == 0)
+			size = 1;
+
+		while (true)
+		{
+			if (void* pMemory{ std::malloc(size) })
+				return pMemory;
+
+			const std::new_handler handler{ std::get_new_handler() };
+			if (!handler)
+				throw std::bad_alloc{};
+			handler();
+		}
+	}
+
+	void* CountedAllocateAligned(std::size_t size, std::align_val_t alignment)
+	{
+		g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+		const std::size_t alignmentValue{ static_cast<std::size_t>(alignment) };
+		//aligned_alloc wants a multiple of the alignment
+		size = (std::max<std::size_t>(size, 1) + alignmentValue - 1) & ~(alignmentValue - 1);
+
+		while (true)
+		{
+#ifdef _WIN32
+			if (void* pMemory{ _aligned_malloc(size, alignmentValue) })
+				return pMemory;
+#else
+			if (void* pMemory{ std::aligned_alloc(alignmentValue, size) })
+				return pMemory;
+#endif
+
+			const std::new_handler handler{ std::get_new_handler() };
+			if (!handler)
+				throw std::bad_alloc{};
+			handler();
+		}
+	}
+
+	void FreeAligned(void* pMemory)
+	{
+#ifdef _WIN32
+		_aligned_free(pMemory);
+#else
+		std::free(pMemory);
+#endif
+	}
+}
+
+namespace dae
+{
+	namespace AllocationCounter
+	{
+		uint64_t GetCount()
+		{
+			return g_AllocationCount.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+//Replacements of the global allocation functions, the nothrow forms forward to these by default
+void* operator new(std::size_t size) { return CountedAllocate(size); }
+void* operator new[](std::size_t size) { return CountedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return CountedAllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return CountedAllocateAligned(size, alignment); }
+
+void operator delete(void* pMemory) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, std::size_t) noexcept { std::free(pMemory); }
+void operator delete[](void* pMemory, std::size_t) noexcept { std::free(pMemory); }
+void operator delete(void* pMemory, std::align_val_t) noexcept { FreeAligned(pMemory); }
+void operator delete[](void* pMemory, std::align_val_t) noexcept { FreeAligned(pMemory); }
+void operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept { FreeAligned(pMemory); }
+void operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept { FreeAligned(pMemory); }
+#endif
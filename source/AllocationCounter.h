@@ -0,0 +1,21 @@
+#pragma once
+
+//Standard includes
+#include <cstdint>
+
+namespace dae
+{
+	//Counts every call to the global operator new of the process. Only when DAE_COUNT_ALLOCATIONS is defined,
+	//AllocationCounter.cpp then replaces the global allocation functions, which no library should do by default.
+	//Take the count before and after a piece of code to see how often it went to the heap
+	namespace AllocationCounter
+	{
+#ifdef DAE_COUNT_ALLOCATIONS
+		constexpr bool IS_ENABLED{ true };
+		uint64_t GetCount();
+#else
+		constexpr bool IS_ENABLED{ false };
+		inline uint64_t GetCount() { return 0; }
+#endif
+	}
+}
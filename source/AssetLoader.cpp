@@ -0,0 +1,150 @@
+#include "pch.h"
+#include "AssetLoader.h"
+#include "HardwareMesh.h"
+#include "HardwareTexture.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "Texture.h"
+
+namespace dae
+{
+	AssetLoader::AssetLoader(ID3D11Device* pDevice, uint32_t numWorkers)
+		: m_pDevice{ pDevice }
+	{
+		const uint32_t numCores{ std::max(std::thread::hardware_concurrency(), 1u) };
+		m_pParsePool = std::make_unique<ThreadPool>(numCores - 1);
+
+		m_Workers.reserve(numWorkers);
+		for (uint32_t i = 0; i < numWorkers; ++i)
+			m_Workers.emplace_back(&AssetLoader::WorkerLoop, this);
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	std::future<TextureAsset> AssetLoader::LoadTexture(const std::string& path)
+	{
+		return Enqueue([this, path]
+			{
+				SDL_Surface* pSurface{ IMG_Load(path.c_str()) };
+				if (pSurface == nullptr)
+					return TextureAsset{};
+
+				//The PNG loader hands out RGB24 or RGBA32 surfaces (and 8 bit paletted ones), RGBA32 is
+				//R8G8B8A8 in memory on every platform, the layout Texture and the D3D upload expect
+				if (pSurface->format->format != SDL_PIXELFORMAT_RGBA32)
+				{
+					SDL_Surface* pConverted{ SDL_ConvertSurfaceFormat(pSurface, SDL_PIXELFORMAT_RGBA32, 0) };
+					SDL_FreeSurface(pSurface);
+					if (pConverted == nullptr)
+					{
+						std::cout << "Texture conversion to RGBA8 failed: " << SDL_GetError() << '\n';
+						return TextureAsset{};
+					}
+					pSurface = pConverted;
+				}
+
+				TextureAsset asset{};
+				asset.pTexture = new Texture{ pSurface->w, pSurface->h, static_cast<const uint32_t*>(pSurface->pixels), pSurface->pitch / static_cast<int>(sizeof(uint32_t)) };
+				SDL_FreeSurface(pSurface);
+
+				if (m_pDevice)
+				{
+					asset.pHardwareTexture = HardwareTexture::Create(*asset.pTexture, m_pDevice);
+					if (asset.pHardwareTexture == nullptr)
+					{
+						delete asset.pTexture;
+						return TextureAsset{};
+					}
+				}
+				return asset;
+			});
+	}
+
+	MeshAsset AssetLoader::LoadMesh(const std::string& filename, Effect* pEffect)
+	{
+		MeshAsset asset{};
+		asset.pMesh = LoadMesh(filename);
+		if (asset.pMesh == nullptr)
+		{
+			delete pEffect;
+			return MeshAsset{};
+		}
+
+		if (pEffect)
+			asset.pHardwareMesh = new HardwareMesh(m_pDevice, *asset.pMesh, pEffect);
+		return asset;
+	}
+
+	Mesh* AssetLoader::LoadMesh(const std::string& filename)
+	{
+		//Every mesh of the scene is parsed the same way, the cache remembers how
+		constexpr bool flipAxisAndWinding{ true };
+		constexpr uint32_t parseFlags{ flipAxisAndWinding ? MeshCache::PARSE_FLIP_AXIS_AND_WINDING : 0u };
+
+		MeshCache::MeshData meshData{};
+		std::unique_ptr<MappedFile> pMeshCache{ MeshCache::Open(filename, parseFlags, meshData) };
+		if (pMeshCache)
+		{
+			std::cout << filename << ": " << meshData.vertexCount << " vertices, " << meshData.indexCount / 3 << " triangles from the mesh cache\n";
+			return new Mesh(std::move(pMeshCache), meshData);
+		}
+
+		//First run or stale cache: parse and optimise once, then map the cache that was just written
+		std::vector<Vertex> vertices{};
+		std::vector<uint32_t> indices{};
+		bool isParsed{};
+		{
+			std::lock_guard lock{ m_ParseMutex };
+			isParsed = ObjLoader::ParseOBJ(filename, vertices, indices, *m_pParsePool, flipAxisAndWinding);
+		}
+		//Missing, truncated or unsupported (relative indices), nothing is optimised or cached
+		if (!isParsed || indices.empty())
+		{
+			std::cout << filename << ": could not be parsed\n";
+			return nullptr;
+		}
+
+		MeshOptimizer::OptimizeMesh(vertices, indices);
+
+		if (MeshCache::Write(filename, parseFlags, vertices, indices))
+		{
+			pMeshCache = MeshCache::Open(filename, parseFlags, meshData);
+			if (pMeshCache)
+				return new Mesh(std::move(pMeshCache), meshData);
+		}
+		return new Mesh(std::move(vertices), std::move(indices));
+	}
+
+	void AssetLoader::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job{};
+			{
+				std::unique_lock lock{ m_Mutex };
+				m_WakeCondition.wait(lock, [this] { return m_IsStopping || !m_Jobs.empty(); });
+
+				//Queued loads still run when stopping, their futures would otherwise never resolve
+				if (m_Jobs.empty())
+					return;
+
+				job = std::move(m_Jobs.front());
+				m_Jobs.pop_front();
+			}
+
+			job();
+		}
+	}
+}
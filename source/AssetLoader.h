@@ -0,0 +1,96 @@
+#pragma once
+#include "pch.h"
+#include "ThreadPool.h"
+
+//Standard includes
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dae
+{
+	class Effect;
+	class HardwareMesh;
+	class HardwareTexture;
+	class Mesh;
+	class Texture;
+
+	//A loaded asset and its GPU copy, the GPU copy is nullptr without a device
+	struct TextureAsset
+	{
+		Texture* pTexture{ nullptr };
+		HardwareTexture* pHardwareTexture{ nullptr };
+	};
+
+	struct MeshAsset
+	{
+		Mesh* pMesh{ nullptr };
+		HardwareMesh* pHardwareMesh{ nullptr };
+	};
+
+	//Loads textures and meshes on background threads and hands out futures, so frames can be drawn while assets decode.
+	//Loads only use the D3D11 device, which is free threaded, the device context stays with the render thread
+	class AssetLoader final
+	{
+	public:
+		//pDevice may be nullptr, then assets are only prepared for the software backend
+		AssetLoader(ID3D11Device* pDevice, uint32_t numWorkers);
+		//Finishes every load that was already queued
+		~AssetLoader();
+
+		AssetLoader(const AssetLoader&) = delete;
+		AssetLoader(AssetLoader&&) noexcept = delete;
+		AssetLoader& operator=(const AssetLoader&) = delete;
+		AssetLoader& operator=(AssetLoader&&) noexcept = delete;
+
+		//Both nullptr when the image cannot be loaded or uploaded
+		std::future<TextureAsset> LoadTexture(const std::string& path);
+
+		//The effect is compiled on the loader thread as well, it costs about as much as mapping the mesh
+		template<typename EffectType>
+		std::future<MeshAsset> LoadMesh(const std::string& filename, const std::wstring& effectFile)
+		{
+			//Without a device (headless) the mesh is software only and gets no effect
+			return Enqueue([this, filename, effectFile] { return LoadMesh(filename, m_pDevice ? new EffectType(m_pDevice, effectFile) : nullptr); });
+		}
+
+	private:
+		template<typename Function>
+		auto Enqueue(Function function) -> std::future<decltype(function())>
+		{
+			using Result = decltype(function());
+			auto pTask{ std::make_shared<std::packaged_task<Result()>>(std::move(function)) };
+			std::future<Result> future{ pTask->get_future() };
+			{
+				std::lock_guard lock{ m_Mutex };
+				m_Jobs.emplace_back([pTask] { (*pTask)(); });
+			}
+			m_WakeCondition.notify_one();
+			return future;
+		}
+
+		//Maps the binary cache of the OBJ file, parses the OBJ and writes the cache when there is none or it is stale.
+		//The GPU copy takes ownership of pEffect
+		MeshAsset LoadMesh(const std::string& filename, Effect* pEffect);
+		Mesh* LoadMesh(const std::string& filename);
+		void WorkerLoop();
+
+		ID3D11Device* m_pDevice;
+
+		std::vector<std::thread> m_Workers{};
+		std::mutex m_Mutex{};
+		std::condition_variable m_WakeCondition{};
+		std::deque<std::function<void()>> m_Jobs{};
+		bool m_IsStopping{ false };
+
+		//ObjLoader splits one file over a whole pool, ThreadPool runs one ParallelFor at a time so meshes take turns
+		std::unique_ptr<ThreadPool> m_pParsePool{};
+		std::mutex m_ParseMutex{};
+	};
+}
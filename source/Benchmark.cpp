@@ -0,0 +1,545 @@
+#include "pch.h"
+#include "Benchmark.h"
+#include "Clipper.h"
+#include "ObjLoader.h"
+#include "SoftwareBackend.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "VertexStage.h"
+#include "Utils.h"
+#include "MathReference.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace dae
+{
+	namespace Benchmark
+	{
+		namespace
+		{
+			constexpr int EDGE_STEPPING_ITERATIONS{ 20 };
+			constexpr int CLIPPING_ITERATIONS{ 20 };
+			constexpr int OBJ_LOADING_ITERATIONS{ 5 };
+			constexpr int VERTEX_TRANSFORMATION_ITERATIONS{ 10 };
+			constexpr size_t VERTEX_TRANSFORMATION_COUNT{ 1024 * 1024 };
+			constexpr int TEXTURE_FILTERING_ITERATIONS{ 5 };
+			//Screen patch of PATCH_SIZE^2 pixels per minification level, the levels step by a factor of two
+			constexpr int TEXTURE_FILTERING_PATCH_SIZE{ 256 };
+			constexpr int TEXTURE_FILTERING_MAX_LOD{ 5 };
+			constexpr int TEXEL_LOCALITY_ITERATIONS{ 5 };
+			//Wider than the simulated cache holds texture rows for, like a triangle spanning the screen
+			constexpr int TEXEL_LOCALITY_PATCH_SIZE{ 512 };
+			constexpr int MATH_LIBRARY_ITERATIONS{ 20 };
+			constexpr size_t MATH_LIBRARY_COUNT{ 64 * 1024 };
+
+			//Typical desktop L1 data cache
+			constexpr size_t CACHE_LINE_SIZE{ 64 };
+			constexpr size_t CACHE_SETS{ 64 };
+			constexpr size_t CACHE_WAYS{ 8 };
+
+			using Clock = std::chrono::high_resolution_clock;
+
+			double SecondsSince(const Clock::time_point& start)
+			{
+				return std::chrono::duration<double>(Clock::now() - start).count();
+			}
+
+			volatile float g_Sink{};
+
+			//Stores a measured result so the compiler cannot drop the work that produced it
+			void DoNotOptimize(float value)
+			{
+				g_Sink = value;
+			}
+
+			Vector2 ToPixels(const Int2& fixedPoint)
+			{
+				return Vector2{ static_cast<float>(fixedPoint.x) / SUBPIXEL_SCALE, static_cast<float>(fixedPoint.y) / SUBPIXEL_SCALE };
+			}
+
+			//The rasterizer before incremental edge stepping: three Vector2::Cross per pixel, column by column
+			uint64_t ScanPerPixelCross(const Int2& fixedP0, const Int2& fixedP1, const Int2& fixedP2, const RasterTriangle& triangle, uint8_t* pCoverage, int width)
+			{
+				const Vector2 p0{ ToPixels(fixedP0) };
+				const Vector2 p1{ ToPixels(fixedP1) };
+				const Vector2 p2{ ToPixels(fixedP2) };
+				const Vector2 e0{ p1 - p0 };
+				const Vector2 e1{ p2 - p1 };
+				const Vector2 e2{ p0 - p2 };
+
+				uint64_t coveredPixels{};
+				for (int px{ triangle.min.x }; px < triangle.max.x; ++px)
+				{
+					for (int py{ triangle.min.y }; py < triangle.max.y; ++py)
+					{
+						const Vector2 currentPixel{ static_cast<float>(px), static_cast<float>(py) };
+
+						const float edge0{ Vector2::Cross(e0, currentPixel - p0) };
+						const float edge1{ Vector2::Cross(e1, currentPixel - p1) };
+						const float edge2{ Vector2::Cross(e2, currentPixel - p2) };
+
+						if ((edge0 > 0 && edge1 > 0 && edge2 > 0) || (edge0 < 0 && edge1 < 0 && edge2 < 0))
+						{
+							pCoverage[px + py * width] = 1;
+							++coveredPixels;
+						}
+					}
+				}
+				return coveredPixels;
+			}
+
+			//The coverage part of SoftwareBackend::RenderTriangle without the SIMD kernel: the fixed point edges of
+			//SetupEdgeEquations, blocks classified at their corners, and the edges stepped along every row of a partial block
+			uint64_t ScanSteppedEdges(const Int2& p0, const Int2& p1, const Int2& p2, const RasterTriangle& triangle, uint8_t* pCoverage, int width)
+			{
+				constexpr int blockSize{ SoftwareBackend::HIZ_BLOCK_SIZE };
+				const EdgeEquations edges{ SoftwareBackend::SetupEdgeEquations(p0, p1, p2) };
+
+				uint64_t coveredPixels{};
+				for (int blockY{ triangle.min.y / blockSize }; blockY <= (triangle.max.y - 1) / blockSize; ++blockY)
+				{
+					const int blockStartY{ std::max(triangle.min.y, blockY * blockSize) };
+					const int blockEndY{ std::min(triangle.max.y, (blockY + 1) * blockSize) };
+
+					for (int blockX{ triangle.min.x / blockSize }; blockX <= (triangle.max.x - 1) / blockSize; ++blockX)
+					{
+						const int blockStartX{ std::max(triangle.min.x, blockX * blockSize) };
+						const int blockEndX{ std::min(triangle.max.x, (blockX + 1) * blockSize) };
+
+						const BlockCoverage blockCoverage{ edges.ClassifyBlock(blockStartX, blockStartY, blockEndX - 1, blockEndY - 1) };
+						if (blockCoverage == BlockCoverage::Outside)
+							continue;
+
+						const bool isBlockInside{ blockCoverage == BlockCoverage::Inside };
+						for (int py{ blockStartY }; py < blockEndY; ++py)
+						{
+							int64_t currEdge0{ edges.Evaluate(0, blockStartX, py) };
+							int64_t currEdge1{ edges.Evaluate(1, blockStartX, py) };
+							int64_t currEdge2{ edges.Evaluate(2, blockStartX, py) };
+
+							uint8_t* pRow{ pCoverage + py * width };
+							for (int px{ blockStartX }; px < blockEndX; ++px, currEdge0 += edges.a[0], currEdge1 += edges.a[1], currEdge2 += edges.a[2])
+							{
+								if (!isBlockInside && !(currEdge0 > edges.threshold[0] && currEdge1 > edges.threshold[1] && currEdge2 > edges.threshold[2]))
+									continue;
+
+								pRow[px] = 1;
+								++coveredPixels;
+							}
+						}
+					}
+				}
+				return coveredPixels;
+			}
+
+			//Set associative cache with LRU replacement, counts the lines that have to come from further out
+			class CacheModel final
+			{
+			public:
+				void Access(const void* pAddress)
+				{
+					//Tags are line + 1 so zero marks an empty way, the ways of a set go from most to least recently used
+					const uint64_t tag{ reinterpret_cast<uintptr_t>(pAddress) / CACHE_LINE_SIZE + 1 };
+					uint64_t* pSet{ &m_Tags[(tag % CACHE_SETS) * CACHE_WAYS] };
+
+					size_t way{};
+					while (way < CACHE_WAYS - 1 && pSet[way] != tag)
+						++way;
+					if (pSet[way] != tag)
+						++m_Misses;
+
+					std::copy_backward(pSet, pSet + way, pSet + way + 1);
+					pSet[0] = tag;
+				}
+
+				uint64_t GetMisses() const { return m_Misses; }
+
+			private:
+				std::vector<uint64_t> m_Tags = std::vector<uint64_t>(CACHE_SETS * CACHE_WAYS);
+				uint64_t m_Misses{};
+			};
+
+			int WrapTexel(int texel, int size)
+			{
+				texel %= size;
+				return texel < 0 ? texel + size : texel;
+			}
+
+			//The four texels a bilinear sample of the base level reads, the same addressing Texture::Sample uses
+			void AccessBilinearFootprint(const Texture& texture, TexelLayout layout, const Vector2& uv, CacheModel& cache)
+			{
+				const int width{ texture.GetWidth() };
+				const int height{ texture.GetHeight() };
+				const int x0{ WrapTexel(static_cast<int>(std::floor((uv.x - std::floor(uv.x)) * width - 0.5f)), width) };
+				const int y0{ WrapTexel(static_cast<int>(std::floor((uv.y - std::floor(uv.y)) * height - 0.5f)), height) };
+				const int x1{ WrapTexel(x0 + 1, width) };
+				const int y1{ WrapTexel(y0 + 1, height) };
+
+				cache.Access(texture.GetTexelAddress(0, x0, y0, layout));
+				cache.Access(texture.GetTexelAddress(0, x1, y0, layout));
+				cache.Access(texture.GetTexelAddress(0, x0, y1, layout));
+				cache.Access(texture.GetTexelAddress(0, x1, y1, layout));
+			}
+
+			//Runs operation over all inputs MATH_LIBRARY_ITERATIONS times, returns millions of operations per second
+			template<typename Operation>
+			double MeasureMathThroughput(Operation operation)
+			{
+				const Clock::time_point start{ Clock::now() };
+				for (int iteration = 0; iteration < MATH_LIBRARY_ITERATIONS; ++iteration)
+				{
+					for (size_t i{}; i < MATH_LIBRARY_COUNT; ++i)
+						operation(i);
+				}
+				return static_cast<double>(MATH_LIBRARY_COUNT) * MATH_LIBRARY_ITERATIONS / SecondsSince(start) / 1e6;
+			}
+		}
+
+		void EdgeStepping(std::span<const Int2> screenVertices, std::span<const uint32_t> indices,
+			std::span<const RasterTriangle> triangles, int width, int height)
+		{
+			std::vector<uint8_t> coverage(static_cast<size_t>(width) * height);
+
+			uint64_t scannedPixels{};
+			for (const RasterTriangle& triangle : triangles)
+				scannedPixels += static_cast<uint64_t>(triangle.max.x - triangle.min.x) * (triangle.max.y - triangle.min.y);
+
+			auto runScan = [&](auto scanFunction, uint64_t& coveredPixels)
+			{
+				coveredPixels = 0;
+				const Clock::time_point start{ Clock::now() };
+				for (int iteration = 0; iteration < EDGE_STEPPING_ITERATIONS; ++iteration)
+				{
+					for (const RasterTriangle& triangle : triangles)
+					{
+						coveredPixels += scanFunction(screenVertices[indices[triangle.idx0]], screenVertices[indices[triangle.idx1]],
+							screenVertices[indices[triangle.idx2]], triangle, coverage.data(), width);
+					}
+				}
+				const double seconds{ SecondsSince(start) };
+				DoNotOptimize(static_cast<float>(coveredPixels));
+				return seconds;
+			};
+
+			uint64_t crossCovered{}, steppedCovered{};
+			const double crossSeconds{ runScan(ScanPerPixelCross, crossCovered) };
+			const double steppedSeconds{ runScan(ScanSteppedEdges, steppedCovered) };
+
+			const double totalPixels{ static_cast<double>(scannedPixels) * EDGE_STEPPING_ITERATIONS };
+
+			std::cout << "--- Edge stepping benchmark: " << triangles.size() << " triangles, "
+				<< scannedPixels << " bounding box pixels, " << EDGE_STEPPING_ITERATIONS << " iterations ---\n";
+			std::cout << "Per pixel Vector2::Cross:        " << totalPixels / crossSeconds / 1e6 << " Mpixels/s ("
+				<< crossCovered / EDGE_STEPPING_ITERATIONS << " covered)\n";
+			std::cout << "Stepped SetupEdgeEquations edges: " << totalPixels / steppedSeconds / 1e6 << " Mpixels/s ("
+				<< steppedCovered / EDGE_STEPPING_ITERATIONS << " covered)\n";
+			std::cout << "Speedup: " << crossSeconds / steppedSeconds << "x\n";
+		}
+
+		void Clipping(std::span<const Vertex_Out> clipVertices, std::span<const uint32_t> indices, PrimitiveTopology topology)
+		{
+			//Winding does not matter here, so strips only differ in the stride
+			const size_t stride{ topology == PrimitiveTopology::TriangleStrip ? 1u : 3u };
+			size_t triangleCount{};
+			for (size_t i{}; i + 2 < indices.size(); i += stride)
+				++triangleCount;
+
+			uint64_t clippedTriangles{};
+			uint64_t rejectedTriangles{};
+			const Clock::time_point classifyStart{ Clock::now() };
+			for (int iteration = 0; iteration < CLIPPING_ITERATIONS; ++iteration)
+			{
+				for (size_t i{}; i + 2 < indices.size(); i += stride)
+				{
+					const Vector4& c0{ clipVertices[indices[i]].position };
+					const Vector4& c1{ clipVertices[indices[i + 1]].position };
+					const Vector4& c2{ clipVertices[indices[i + 2]].position };
+
+					if (Clipper::ComputeOutCode(c0, 1.f) & Clipper::ComputeOutCode(c1, 1.f) & Clipper::ComputeOutCode(c2, 1.f))
+						++rejectedTriangles;
+					else if (Clipper::ComputeOutCode(c0, Clipper::GUARD_BAND) | Clipper::ComputeOutCode(c1, Clipper::GUARD_BAND) | Clipper::ComputeOutCode(c2, Clipper::GUARD_BAND))
+						++clippedTriangles;
+				}
+			}
+			const double classifySeconds{ SecondsSince(classifyStart) };
+
+			constexpr uint8_t allPlanes{ Clipper::OUT_NEAR | Clipper::OUT_FAR | Clipper::OUT_LEFT | Clipper::OUT_RIGHT | Clipper::OUT_BOTTOM | Clipper::OUT_TOP };
+			Vertex_Out polygon[Clipper::MAX_POLYGON_VERTICES];
+			uint64_t polygonVertices{};
+			const Clock::time_point clipStart{ Clock::now() };
+			for (int iteration = 0; iteration < CLIPPING_ITERATIONS; ++iteration)
+			{
+				for (size_t i{}; i + 2 < indices.size(); i += stride)
+				{
+					polygonVertices += Clipper::ClipTriangle(clipVertices[indices[i]], clipVertices[indices[i + 1]],
+						clipVertices[indices[i + 2]], allPlanes, polygon);
+				}
+			}
+			const double clipSeconds{ SecondsSince(clipStart) };
+
+			const double totalTriangles{ static_cast<double>(triangleCount) * CLIPPING_ITERATIONS };
+
+			std::cout << "--- Clipping benchmark: " << triangleCount << " triangles, " << CLIPPING_ITERATIONS << " iterations ---\n";
+			std::cout << "Out codes only:            " << totalTriangles / classifySeconds / 1e6 << " Mtriangles/s ("
+				<< rejectedTriangles / CLIPPING_ITERATIONS << " rejected, " << clippedTriangles / CLIPPING_ITERATIONS << " need clipping)\n";
+			std::cout << "Clip against all 6 planes: " << totalTriangles / clipSeconds / 1e6 << " Mtriangles/s ("
+				<< polygonVertices / CLIPPING_ITERATIONS << " polygon vertices)\n";
+			std::cout << "Worst case per frame:      " << triangleCount / (totalTriangles / clipSeconds) * 1e3 << " ms\n";
+		}
+
+		void ObjLoading(const std::string& filename, ThreadPool& threadPool)
+		{
+			std::vector<Vertex> streamVertices{}, mappedVertices{};
+			std::vector<uint32_t> streamIndices{}, mappedIndices{};
+
+			bool isLoaded{ true };
+			const Clock::time_point streamStart{ Clock::now() };
+			for (int iteration = 0; iteration < OBJ_LOADING_ITERATIONS; ++iteration)
+				isLoaded &= Utils::ParseOBJ(filename, streamVertices, streamIndices, true, false);
+			const double streamSeconds{ SecondsSince(streamStart) / OBJ_LOADING_ITERATIONS };
+
+			const Clock::time_point mappedStart{ Clock::now() };
+			for (int iteration = 0; iteration < OBJ_LOADING_ITERATIONS; ++iteration)
+				isLoaded &= ObjLoader::ParseOBJ(filename, mappedVertices, mappedIndices, threadPool, true, false);
+			const double mappedSeconds{ SecondsSince(mappedStart) / OBJ_LOADING_ITERATIONS };
+
+			if (!isLoaded)
+			{
+				std::cout << "--- OBJ loading benchmark: could not load " << filename << " ---\n";
+				return;
+			}
+
+			//Both go through Utils::BuildIndexedMesh, so any difference comes from the text parsing
+			const bool isSameMesh{ streamIndices == mappedIndices && streamVertices.size() == mappedVertices.size() &&
+				std::memcmp(streamVertices.data(), mappedVertices.data(), streamVertices.size() * sizeof(Vertex)) == 0 };
+
+			std::cout << "--- OBJ loading benchmark: " << filename << ", " << mappedIndices.size() / 3 << " triangles, "
+				<< OBJ_LOADING_ITERATIONS << " iterations ---\n";
+			std::cout << "std::ifstream, 1 thread:          " << streamSeconds * 1e3 << " ms\n";
+			std::cout << "Memory mapped, " << threadPool.GetNumThreads() << " thread(s), from_chars: " << mappedSeconds * 1e3 << " ms\n";
+			std::cout << "Speedup: " << streamSeconds / mappedSeconds << "x, meshes " << (isSameMesh ? "identical" : "DIFFER") << "\n";
+		}
+
+		void VertexTransformation(std::span<const Vertex> vertices, const Matrix& worldViewProjection, const Matrix& world,
+			RasterKernels::KernelType kernelType, ThreadPool& threadPool)
+		{
+			if (vertices.empty())
+				return;
+
+			std::vector<Vertex> benchmarkVertices{};
+			benchmarkVertices.reserve(VERTEX_TRANSFORMATION_COUNT + vertices.size());
+			while (benchmarkVertices.size() < VERTEX_TRANSFORMATION_COUNT)
+				benchmarkVertices.insert(benchmarkVertices.end(), vertices.begin(), vertices.end());
+
+			VertexStreams streams{};
+			streams.Build(benchmarkVertices);
+			const size_t vertexCount{ streams.vertexCount };
+
+			const auto measure{ [&](std::vector<Vertex_Out>& verticesOut, auto&& transform)
+				{
+					verticesOut.resize(vertexCount);
+					const Clock::time_point start{ Clock::now() };
+					for (int iteration = 0; iteration < VERTEX_TRANSFORMATION_ITERATIONS; ++iteration)
+						transform(verticesOut.data());
+					return static_cast<double>(vertexCount) * VERTEX_TRANSFORMATION_ITERATIONS / SecondsSince(start);
+				} };
+
+			const VertexStage::TransformFunction scalar{ VertexStage::GetTransformFunction(RasterKernels::KernelType::Scalar) };
+			const VertexStage::TransformFunction best{ VertexStage::GetTransformFunction(kernelType) };
+
+			std::vector<Vertex_Out> scalarOut{}, bestOut{}, threadedOut{};
+			const double scalarRate{ measure(scalarOut, [&](Vertex_Out* pOut) { scalar(streams, benchmarkVertices, worldViewProjection, world, 0, vertexCount, pOut); }) };
+			const double bestRate{ measure(bestOut, [&](Vertex_Out* pOut) { best(streams, benchmarkVertices, worldViewProjection, world, 0, vertexCount, pOut); }) };
+			const double threadedRate{ measure(threadedOut, [&](Vertex_Out* pOut)
+				{
+					VertexStage::TransformVertices(best, streams, benchmarkVertices, worldViewProjection, world, pOut, threadPool);
+				}) };
+
+			//Vertex_Out is all floats, so a byte compare is an exact compare
+			const size_t byteCount{ vertexCount * sizeof(Vertex_Out) };
+			const bool isSameOutput{ std::memcmp(scalarOut.data(), bestOut.data(), byteCount) == 0 &&
+				std::memcmp(scalarOut.data(), threadedOut.data(), byteCount) == 0 };
+
+			std::cout << "--- Vertex transformation benchmark: " << vertexCount << " vertices, " << VERTEX_TRANSFORMATION_ITERATIONS << " iterations ---\n";
+			std::cout << "Scalar, 1 thread:         " << scalarRate / 1e6 << " Mvertices/s\n";
+			std::cout << RasterKernels::GetKernelName(kernelType) << ", 1 thread: " << bestRate / 1e6 << " Mvertices/s\n";
+			std::cout << RasterKernels::GetKernelName(kernelType) << ", " << threadPool.GetNumThreads() << " thread(s): " << threadedRate / 1e6 << " Mvertices/s\n";
+			std::cout << "Speedup: " << bestRate / scalarRate << "x (SIMD), " << threadedRate / scalarRate << "x (SIMD + threads), outputs "
+				<< (isSameOutput ? "identical" : "DIFFER") << "\n";
+		}
+
+		void TextureFiltering(const Texture& texture, TexelLayout layout)
+		{
+			struct FilterMode
+			{
+				const char* name;
+				TextureFilter filter;
+				bool useDerivatives;
+				int texelsPerSample;
+			};
+			const FilterMode filterModes[]
+			{
+				{ "Point, base level", TextureFilter::Point, false, 1 },
+				{ "Point", TextureFilter::Point, true, 1 },
+				{ "Bilinear", TextureFilter::Bilinear, true, 4 },
+				{ "Trilinear", TextureFilter::Trilinear, true, 8 },
+			};
+
+			//Patches rotated by 30 degrees so neither texture rows nor columns line up with the screen
+			const Vector2 axisX{ 0.866f / texture.GetWidth(), 0.5f / texture.GetHeight() };
+			const Vector2 axisY{ -0.5f / texture.GetWidth(), 0.866f / texture.GetHeight() };
+			const uint64_t samplesPerIteration{ static_cast<uint64_t>(TEXTURE_FILTERING_PATCH_SIZE) * TEXTURE_FILTERING_PATCH_SIZE * (TEXTURE_FILTERING_MAX_LOD + 1) };
+
+			std::cout << "--- Texture filtering benchmark: " << samplesPerIteration << " samples, lod 0.5 to " << TEXTURE_FILTERING_MAX_LOD << ".5, "
+				<< (layout == TexelLayout::Tiled ? "tiled" : "linear") << " texels, " << TEXTURE_FILTERING_ITERATIONS << " iterations ---\n";
+			std::cout << "Memory: base level " << texture.GetBaseLevelSize() / 1024 << " KB, with " << texture.GetNumMipLevels() << " mip levels "
+				<< texture.GetMipChainSize() / 1024 << " KB (+" << 100.0 * (static_cast<double>(texture.GetMipChainSize()) / texture.GetBaseLevelSize() - 1.0) << "%)\n";
+
+			for (const FilterMode& mode : filterModes)
+			{
+				const Clock::time_point start{ Clock::now() };
+				for (int iteration = 0; iteration < TEXTURE_FILTERING_ITERATIONS; ++iteration)
+				{
+					for (int lod{}; lod <= TEXTURE_FILTERING_MAX_LOD; ++lod)
+					{
+						//Half way between two levels, where trilinear actually blends
+						const float texelsPerPixel{ std::exp2(static_cast<float>(lod) + 0.5f) };
+						const UvDerivatives derivatives{ texelsPerPixel * axisX, texelsPerPixel * axisY };
+						const UvDerivatives usedDerivatives{ mode.useDerivatives ? derivatives : UvDerivatives{} };
+
+						for (int py{}; py < TEXTURE_FILTERING_PATCH_SIZE; ++py)
+						{
+							for (int px{}; px < TEXTURE_FILTERING_PATCH_SIZE; ++px)
+							{
+								const Vector2 uv{ static_cast<float>(px) * derivatives.dx + static_cast<float>(py) * derivatives.dy };
+								DoNotOptimize(texture.Sample(uv, usedDerivatives, mode.filter, layout).r);
+							}
+						}
+					}
+				}
+				const double seconds{ SecondsSince(start) };
+
+				std::cout << mode.name << ": " << samplesPerIteration * TEXTURE_FILTERING_ITERATIONS / seconds / 1e6 << " Msamples/s, "
+					<< mode.texelsPerSample << " texel(s) per sample\n";
+			}
+		}
+
+		void TexelCacheLocality(const Texture& texture)
+		{
+			constexpr TexelLayout layouts[]{ TexelLayout::Linear, TexelLayout::Tiled };
+			constexpr int angles[]{ 0, 30, 45, 90 };
+			const uint64_t fragmentCount{ static_cast<uint64_t>(TEXEL_LOCALITY_PATCH_SIZE) * TEXEL_LOCALITY_PATCH_SIZE };
+
+			std::cout << "--- Texel layout benchmark: " << TEXEL_LOCALITY_PATCH_SIZE << "x" << TEXEL_LOCALITY_PATCH_SIZE
+				<< " fragments in row order, bilinear at one texel per pixel, " << TEXEL_LOCALITY_ITERATIONS << " iterations ---\n";
+			std::cout << "Memory: linear chain " << texture.GetMipChainSize() / 1024 << " KB, tiled chain " << texture.GetTiledMipChainSize() / 1024
+				<< " KB, cache model " << CACHE_SETS * CACHE_WAYS * CACHE_LINE_SIZE / 1024 << " KB " << CACHE_WAYS << "-way\n";
+
+			for (int angle : angles)
+			{
+				const float radians{ static_cast<float>(angle) * PI / 180.f };
+				const Vector2 axisX{ std::cos(radians) / texture.GetWidth(), std::sin(radians) / texture.GetHeight() };
+				const Vector2 axisY{ -std::sin(radians) / texture.GetWidth(), std::cos(radians) / texture.GetHeight() };
+				const UvDerivatives derivatives{ axisX, axisY };
+				auto fragmentUv = [&](int px, int py)
+					{
+						return Vector2{ 0.5f, 0.5f } + static_cast<float>(px) * axisX + static_cast<float>(py) * axisY;
+					};
+
+				std::cout << "Rotated " << angle << " degrees:";
+				for (TexelLayout layout : layouts)
+				{
+					CacheModel cache{};
+					for (int py{}; py < TEXEL_LOCALITY_PATCH_SIZE; ++py)
+					{
+						for (int px{}; px < TEXEL_LOCALITY_PATCH_SIZE; ++px)
+							AccessBilinearFootprint(texture, layout, fragmentUv(px, py), cache);
+					}
+
+					const Clock::time_point start{ Clock::now() };
+					for (int iteration = 0; iteration < TEXEL_LOCALITY_ITERATIONS; ++iteration)
+					{
+						for (int py{}; py < TEXEL_LOCALITY_PATCH_SIZE; ++py)
+						{
+							for (int px{}; px < TEXEL_LOCALITY_PATCH_SIZE; ++px)
+								DoNotOptimize(texture.Sample(fragmentUv(px, py), derivatives, TextureFilter::Bilinear, layout).r);
+						}
+					}
+					const double seconds{ SecondsSince(start) };
+
+					std::cout << (layout == TexelLayout::Tiled ? " | tiled " : " linear ") << static_cast<double>(cache.GetMisses()) / fragmentCount << " misses/fragment, "
+						<< fragmentCount * TEXEL_LOCALITY_ITERATIONS / seconds / 1e6 << " Msamples/s";
+				}
+				std::cout << "\n";
+			}
+		}
+
+		void MathLibrary()
+		{
+			std::mt19937 generator{ 21 };
+			std::uniform_real_distribution<float> coordinate{ -100.f, 100.f };
+
+			std::vector<Matrix> matrices(MATH_LIBRARY_COUNT);
+			std::vector<Vector4> points(MATH_LIBRARY_COUNT);
+			std::vector<Vector3> vectors(MATH_LIBRARY_COUNT);
+			for (size_t i{}; i < MATH_LIBRARY_COUNT; ++i)
+			{
+				matrices[i] = MathReference::RandomMatrix(generator);
+				points[i] = { coordinate(generator), coordinate(generator), coordinate(generator), 1.f };
+				vectors[i] = { coordinate(generator), coordinate(generator), coordinate(generator) };
+			}
+			//Every input against its neighbour, wrapping around
+			auto next = [](size_t i) { return (i + 1) % MATH_LIBRARY_COUNT; };
+
+			float multiplyDifference{}, pointDifference{}, vectorDifference{}, inverseResidual{}, crossDifference{};
+			for (size_t i{}; i < MATH_LIBRARY_COUNT; ++i)
+			{
+				const Matrix& m{ matrices[i] };
+				multiplyDifference = std::max(multiplyDifference, MathReference::MaxDifference(m * matrices[next(i)], MathReference::Multiply(m, matrices[next(i)])));
+				pointDifference = std::max(pointDifference, MathReference::MaxDifference(m.TransformPoint(points[i]), MathReference::TransformPoint(m, points[i])));
+				vectorDifference = std::max(vectorDifference, MathReference::MaxDifference(m.TransformVector(vectors[i]).Normalized().ToVector4(),
+					MathReference::TransformVector(m, vectors[i]).Normalized().ToVector4()));
+				inverseResidual = std::max(inverseResidual, MathReference::MaxDifference(m * Matrix::Inverse(m), Matrix{}));
+				const Vector3 cross{ Vector3::Cross(vectors[i], vectors[next(i)]) };
+				crossDifference = std::max(crossDifference, std::abs(Vector3::Dot(cross, vectors[i])) / (cross.Magnitude() * vectors[i].Magnitude()));
+			}
+
+			struct Result
+			{
+				const char* name;
+				double libraryRate;
+				double referenceRate;
+				float difference;
+			};
+			const Result results[]{
+				{ "Matrix * Matrix",
+					MeasureMathThroughput([&](size_t i) { DoNotOptimize((matrices[i] * matrices[next(i)])[3].w); }),
+					MeasureMathThroughput([&](size_t i) { DoNotOptimize(MathReference::Multiply(matrices[i], matrices[next(i)])[3].w); }),
+					multiplyDifference },
+				{ "TransformPoint(Vector4)",
+					MeasureMathThroughput([&](size_t i) { DoNotOptimize(matrices[i].TransformPoint(points[i]).w); }),
+					MeasureMathThroughput([&](size_t i) { DoNotOptimize(MathReference::TransformPoint(matrices[i], points[i]).w); }),
+					pointDifference },
+				{ "TransformVector + Normalized",
+					MeasureMathThroughput([&](size_t i) { DoNotOptimize(matrices[i].TransformVector(vectors[i]).Normalized().z); }),
+					MeasureMathThroughput([&](size_t i) { DoNotOptimize(MathReference::TransformVector(matrices[i], vectors[i]).Normalized().z); }),
+					vectorDifference },
+			};
+
+			std::cout << "--- Math library benchmark: " << MATH_LIBRARY_COUNT << " random inputs, " << MATH_LIBRARY_ITERATIONS << " iterations, "
+				<< (DAE_SIMD_SSE2 ? "SSE2" : "scalar") << " build ---\n";
+			for (const Result& result : results)
+			{
+				std::cout << result.name << ": " << result.libraryRate << " M/s vs reference " << result.referenceRate
+					<< " M/s, max difference " << result.difference << "\n";
+			}
+
+			const double inverseRate{ MeasureMathThroughput([&](size_t i) { DoNotOptimize(Matrix::Inverse(matrices[i])[3].x); }) };
+			const double crossRate{ MeasureMathThroughput([&](size_t i) { DoNotOptimize(Vector3::Cross(vectors[i], vectors[next(i)]).x
+				+ Vector2::Cross(vectors[i].GetXY(), vectors[next(i)].GetXY())); }) };
+			std::cout << "Inverse: " << inverseRate << " M/s, max |M * Inverse(M) - I| " << inverseResidual << "\n";
+			std::cout << "Vector3 + Vector2 Cross: " << crossRate << " M/s, max |cos| between Cross(a, b) and a " << crossDifference << "\n";
+		}
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Math.h"
+#include "DataTypes.h"
+#include "RasterKernels.h"
+#include <span>
+#include <string>
+
+namespace dae
+{
+	class ThreadPool;
+	class Texture;
+	enum class TexelLayout;
+
+	//Micro-benchmarks for the software pipeline, results are printed to the console
+	namespace Benchmark
+	{
+		//Coverage-only scan of every screen space triangle of the last frame, in Mpixels/s of bounding box:
+		//per pixel Vector2::Cross in column order (the old RenderTriangle) vs the fixed point edges RenderTriangle steps now
+		void EdgeStepping(std::span<const Int2> screenVertices, std::span<const uint32_t> indices,
+			std::span<const RasterTriangle> triangles, int width, int height);
+
+		//Clipper throughput on every mesh triangle: out code classification only,
+		//and the worst case of clipping each triangle against all six planes
+		void Clipping(std::span<const Vertex_Out> clipVertices, std::span<const uint32_t> indices, PrimitiveTopology topology);
+
+		//Load time of an OBJ file: std::ifstream Utils::ParseOBJ vs the memory mapped, multithreaded ObjLoader,
+		//also checks that both produce the same mesh
+		void ObjLoading(const std::string& filename, ThreadPool& threadPool);
+
+		//Vertex stage throughput in vertices/s: scalar vs the SoA AVX2 version on one thread, and split over the pool.
+		//The mesh is repeated until the vertex count is big enough for the threaded path, also checks that all agree
+		void VertexTransformation(std::span<const Vertex> vertices, const Matrix& worldViewProjection, const Matrix& world,
+			RasterKernels::KernelType kernelType, ThreadPool& threadPool);
+
+		//Texture::Sample throughput per filter mode over screen patches minified 1.4x to 45x, plus the memory of the mip chain.
+		//"Point, base level" ignores the derivatives, which is how the software path sampled before mipmapping
+		void TextureFiltering(const Texture& texture, TexelLayout layout);
+
+		//Linear vs 4x4 tiled texels for bilinear sampling at one texel per pixel, with the screen patch rotated in texture space.
+		//Reports cache misses per fragment from a simulated 32 KB 8-way L1, and the measured Texture::Sample throughput
+		void TexelCacheLocality(const Texture& texture);
+
+		//The header-only Vector/Matrix code against a scalar copy of the former out-of-line implementation, on random inputs:
+		//largest difference (0 means bit-identical), the Inverse residual |M * Inverse(M) - I| and the throughput of both
+		void MathLibrary();
+	}
+}
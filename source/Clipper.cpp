@@ -0,0 +1,103 @@
+#include "pch.h"
+#include "Clipper.h"
+
+namespace dae
+{
+	namespace Clipper
+	{
+		namespace
+		{
+			//Signed distance to a clip plane, positive on the inside
+			float GetPlaneDistance(const Vector4& position, OutCode plane)
+			{
+				switch (plane)
+				{
+				case OUT_NEAR:		return position.z;
+				case OUT_FAR:		return position.w - position.z;
+				case OUT_LEFT:		return position.x + GUARD_BAND * position.w;
+				case OUT_RIGHT:		return GUARD_BAND * position.w - position.x;
+				case OUT_BOTTOM:	return position.y + GUARD_BAND * position.w;
+				default:			return GUARD_BAND * position.w - position.y;
+				}
+			}
+
+			//Clip space is still linear, so every attribute is interpolated with the same factor
+			Vertex_Out LerpVertex(const Vertex_Out& v0, const Vertex_Out& v1, float factor)
+			{
+				Vertex_Out vertex{};
+				vertex.position = v0.position + (v1.position - v0.position) * factor;
+				vertex.color = ColorRGB::Lerp(v0.color, v1.color, factor);
+				vertex.uv = v0.uv + (v1.uv - v0.uv) * factor;
+				vertex.normal = v0.normal + (v1.normal - v0.normal) * factor;
+				vertex.tangent = v0.tangent + (v1.tangent - v0.tangent) * factor;
+				vertex.viewDirection = v0.viewDirection + (v1.viewDirection - v0.viewDirection) * factor;
+				return vertex;
+			}
+
+			int ClipPolygon(const Vertex_Out* pInput, int inputCount, OutCode plane, Vertex_Out* pOutput)
+			{
+				int outputCount{};
+				const Vertex_Out* pPrevious{ &pInput[inputCount - 1] };
+				float previousDistance{ GetPlaneDistance(pPrevious->position, plane) };
+
+				for (int i{}; i < inputCount; ++i)
+				{
+					const Vertex_Out& current{ pInput[i] };
+					const float currentDistance{ GetPlaneDistance(current.position, plane) };
+
+					//Edge crosses the plane: emit the intersection
+					if ((previousDistance >= 0.f) != (currentDistance >= 0.f))
+						pOutput[outputCount++] = LerpVertex(*pPrevious, current, previousDistance / (previousDistance - currentDistance));
+
+					if (currentDistance >= 0.f)
+						pOutput[outputCount++] = current;
+
+					pPrevious = &current;
+					previousDistance = currentDistance;
+				}
+				return outputCount;
+			}
+		}
+
+		uint8_t ComputeOutCode(const Vector4& position, float xyExtent)
+		{
+			const float extent{ xyExtent * position.w };
+
+			uint8_t outCode{};
+			if (position.z < 0.f)			outCode |= OUT_NEAR;
+			if (position.z > position.w)	outCode |= OUT_FAR;
+			if (position.x < -extent)		outCode |= OUT_LEFT;
+			if (position.x > extent)		outCode |= OUT_RIGHT;
+			if (position.y < -extent)		outCode |= OUT_BOTTOM;
+			if (position.y > extent)		outCode |= OUT_TOP;
+			return outCode;
+		}
+
+		int ClipTriangle(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, uint8_t clipPlanes, Vertex_Out* pPolygon)
+		{
+			//Ping-pong between the output and a scratch polygon, one plane at a time
+			Vertex_Out scratch[MAX_POLYGON_VERTICES];
+			Vertex_Out* pInput{ pPolygon };
+			Vertex_Out* pOutput{ scratch };
+
+			pInput[0] = v0;
+			pInput[1] = v1;
+			pInput[2] = v2;
+			int vertexCount{ 3 };
+
+			for (uint8_t plane{ OUT_NEAR }; plane <= OUT_TOP && vertexCount > 0; plane <<= 1)
+			{
+				if (!(clipPlanes & plane))
+					continue;
+
+				vertexCount = ClipPolygon(pInput, vertexCount, static_cast<OutCode>(plane), pOutput);
+				std::swap(pInput, pOutput);
+			}
+
+			if (pInput != pPolygon)
+				std::copy_n(pInput, vertexCount, pPolygon);
+
+			return vertexCount;
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "Math.h"
+#include "DataTypes.h"
+
+namespace dae
+{
+	//Clip space triangle clipping, runs before the perspective divide (D3D convention: 0 <= z <= w)
+	namespace Clipper
+	{
+		//x and y are only clipped once a vertex leaves [-GUARD_BAND * w, GUARD_BAND * w],
+		//everything inside that range is left to the screen clamped bounding box of the rasterizer
+		constexpr float GUARD_BAND{ 8.f };
+
+		//Near, far and the four guard band planes each add at most one vertex
+		constexpr int MAX_POLYGON_VERTICES{ 3 + 6 };
+
+		enum OutCode : uint8_t
+		{
+			OUT_NEAR = 1 << 0,
+			OUT_FAR = 1 << 1,
+			OUT_LEFT = 1 << 2,
+			OUT_RIGHT = 1 << 3,
+			OUT_BOTTOM = 1 << 4,
+			OUT_TOP = 1 << 5
+		};
+
+		//Planes the clip space position lies outside of, x and y are tested against [-xyExtent * w, xyExtent * w]
+		uint8_t ComputeOutCode(const Vector4& position, float xyExtent);
+
+		//Sutherland-Hodgman against the planes in clipPlanes, writes the convex result to pPolygon
+		//(MAX_POLYGON_VERTICES entries) and returns its vertex count, 0 when nothing is left.
+		//The winding of the input triangle is kept, so the polygon can be fanned from vertex 0
+		int ClipTriangle(const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, uint8_t clipPlanes, Vertex_Out* pPolygon);
+	}
+}
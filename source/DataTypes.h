@@ -24,6 +24,67 @@ namespace dae
 		Vector3 viewDirection{};
 	};
 
+	struct RasterTriangle
+	{
+		//Positions in the mesh index buffer
+		int idx0{};
+		int idx1{};
+		int idx2{};
+
+		//Pixels whose sample position lies in the snapped bounding box, clamped to the screen (max is exclusive)
+		Int2 min{};
+		Int2 max{};
+	};
+
+	//Screen positions are snapped to 28.4 fixed point before rasterization
+	constexpr int SUBPIXEL_BITS{ 4 };
+	constexpr int SUBPIXEL_SCALE{ 1 << SUBPIXEL_BITS };
+
+	enum class BlockCoverage
+	{
+		Outside,
+		Partial,
+		Inside
+	};
+
+	struct EdgeEquations
+	{
+		//Edge function opposite vertex i at the integer pixel (px, py) is a[i] * px + b[i] * py + c[i], in 1/256 pixel^2
+		int64_t a[3]{};
+		int64_t b[3]{};
+		int64_t c[3]{};
+
+		//Top-left rule: a sample is covered when every edge is above its threshold.
+		//-1 lets samples exactly on a top or left edge in, 0 keeps them out
+		int64_t threshold[3]{};
+
+		//Twice the triangle area in the same units, the equations are flipped so that it is never negative
+		int64_t doubleArea{};
+
+		int64_t Evaluate(int edge, int px, int py) const { return a[edge] * px + b[edge] * py + c[edge]; }
+
+		//Tests the pixels [minX, maxX] x [minY, maxY] (inclusive) at their corners: the edges are linear,
+		//so their extremes over the block are at the corners
+		BlockCoverage ClassifyBlock(int minX, int minY, int maxX, int maxY) const
+		{
+			bool isInside{ true };
+			for (int i{}; i < 3; ++i)
+			{
+				const int64_t cornerEdge{ Evaluate(i, minX, minY) };
+				const int64_t stepX{ a[i] * (maxX - minX) };
+				const int64_t stepY{ b[i] * (maxY - minY) };
+
+				const int64_t maxEdge{ cornerEdge + std::max<int64_t>(stepX, 0) + std::max<int64_t>(stepY, 0) };
+				if (maxEdge <= threshold[i])
+					return BlockCoverage::Outside;
+
+				const int64_t minEdge{ cornerEdge + std::min<int64_t>(stepX, 0) + std::min<int64_t>(stepY, 0) };
+				isInside &= minEdge > threshold[i];
+			}
+			return isInside ? BlockCoverage::Inside : BlockCoverage::Partial;
+		}
+	};
+
 	enum class PrimitiveTopology
 	{
 		TriangleList,
@@ -1,7 +1,7 @@
 #pragma once
 #include "pch.h"
 #include "Math.h"
-#include "Texture.h"
+#include "HardwareTexture.h"
 
 namespace dae
 {
@@ -117,7 +117,7 @@ namespace dae
 		void SetWorldViewProjMatrixData(Matrix worldViewProjectionMatrix) { m_pMatWorldViewProjVariable->SetMatrix(reinterpret_cast<const float*>(&worldViewProjectionMatrix)); }
 		void SetWorldMatrixData(Matrix worldMatrix) { if(m_pWorldMatrixVariable) m_pWorldMatrixVariable->SetMatrix(reinterpret_cast<const float*>(&worldMatrix)); }
 		void SetInvViewMatrixData(Matrix invViewMatrix) { if (m_pInvViewMatrixVariable) m_pInvViewMatrixVariable->SetMatrix(reinterpret_cast<const float*>(&invViewMatrix)); }
-		void SetDiffuseMap(Texture* pDiffuseTexture) { if (m_pDiffuseMapVariable) m_pDiffuseMapVariable->SetResource(pDiffuseTexture->GetSRV()); }
+		void SetDiffuseMap(const HardwareTexture* pDiffuseTexture) { if (m_pDiffuseMapVariable) m_pDiffuseMapVariable->SetResource(pDiffuseTexture->GetSRV()); }
 		void SetRasterizerState(ID3D11RasterizerState* pRasterizerState) { if (m_pRasterizerVariable) m_pRasterizerVariable->SetRasterizerState(0, pRasterizerState); }
 
 		static ID3DX11Effect* LoadEffect(ID3D11Device* pDevice, const std::wstring& assetFile)
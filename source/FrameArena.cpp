@@ -0,0 +1,69 @@
+#include "pch.h"
+#include "FrameArena.h"
+
+namespace dae
+{
+	namespace
+	{
+		//Every block starts on a cache line, so SIMD loads of arena data never straddle one needlessly
+		constexpr size_t BLOCK_ALIGNMENT{ 64 };
+
+		std::byte* AllocateBlock(size_t size)
+		{
+			return static_cast<std::byte*>(::operator new(size, std::align_val_t{ BLOCK_ALIGNMENT }));
+		}
+
+		void FreeBlock(std::byte* pBlock)
+		{
+			::operator delete(pBlock, std::align_val_t{ BLOCK_ALIGNMENT });
+		}
+	}
+
+	FrameArena::FrameArena(size_t initialCapacity)
+		: m_pBlock{ AllocateBlock(initialCapacity) }
+		, m_Capacity{ initialCapacity }
+	{
+	}
+
+	FrameArena::~FrameArena()
+	{
+		for (std::byte* pBlock : m_OverflowBlocks)
+			FreeBlock(pBlock);
+		FreeBlock(m_pBlock);
+	}
+
+	void FrameArena::Reset()
+	{
+		if (!m_OverflowBlocks.empty())
+		{
+			//Grow to what the last frame needed in total, so the same frame fits in one block next time
+			const size_t newCapacity{ std::max(m_Offset + m_OverflowSize, m_Capacity * 2) };
+
+			for (std::byte* pBlock : m_OverflowBlocks)
+				FreeBlock(pBlock);
+			m_OverflowBlocks.clear();
+			m_OverflowSize = 0;
+
+			FreeBlock(m_pBlock);
+			m_pBlock = AllocateBlock(newCapacity);
+			m_Capacity = newCapacity;
+		}
+		m_Offset = 0;
+	}
+
+	void* FrameArena::AllocateBytes(size_t size, size_t alignment)
+	{
+		const size_t alignedOffset{ (m_Offset + alignment - 1) & ~(alignment - 1) };
+		if (alignedOffset + size <= m_Capacity)
+		{
+			m_Offset = alignedOffset + size;
+			return m_pBlock + alignedOffset;
+		}
+
+		//Out of space this frame: hand out a separate block instead of moving what was already allocated
+		std::byte* pBlock{ AllocateBlock(std::max<size_t>(size, 1)) };
+		m_OverflowBlocks.push_back(pBlock);
+		m_OverflowSize += size + BLOCK_ALIGNMENT;
+		return pBlock;
+	}
+}
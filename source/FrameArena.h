@@ -0,0 +1,67 @@
+#pragma once
+
+//Standard includes
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace dae
+{
+	//Linear allocator for the transient buffers of one frame. Allocating bumps an offset and Reset rewinds it,
+	//so once the arena has grown to the largest frame seen, frames no longer touch the heap
+	class FrameArena final
+	{
+	public:
+		explicit FrameArena(size_t initialCapacity);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena(FrameArena&&) noexcept = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+		FrameArena& operator=(FrameArena&&) noexcept = delete;
+
+		//Invalidates every span handed out since the last Reset
+		void Reset();
+
+		//Uninitialized storage for count elements, only for types that need no destructor
+		template<typename T>
+		std::span<T> Allocate(size_t count)
+		{
+			static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "The arena never runs destructors");
+			return { static_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T))), count };
+		}
+
+		template<typename T>
+		std::span<T> Copy(std::span<const T> source)
+		{
+			const std::span<T> destination{ Allocate<T>(source.size()) };
+			std::copy(source.begin(), source.end(), destination.begin());
+			return destination;
+		}
+
+		//first followed by second in one arena allocation
+		template<typename T>
+		std::span<T> Concatenate(std::span<const T> first, std::span<const T> second)
+		{
+			const std::span<T> destination{ Allocate<T>(first.size() + second.size()) };
+			std::copy(second.begin(), second.end(), std::copy(first.begin(), first.end(), destination.begin()));
+			return destination;
+		}
+
+		size_t GetCapacity() const { return m_Capacity; }
+
+	private:
+		void* AllocateBytes(size_t size, size_t alignment);
+
+		std::byte* m_pBlock{ nullptr };
+		size_t m_Capacity{};
+		size_t m_Offset{};
+
+		//Allocations that did not fit in the block, merged into one bigger block by the next Reset
+		std::vector<std::byte*> m_OverflowBlocks{};
+		size_t m_OverflowSize{};
+	};
+}
@@ -0,0 +1,114 @@
+#include "pch.h"
+#include "FramePresenter.h"
+
+namespace dae
+{
+	FramePresenter::FramePresenter(SDL_Window* pWindow)
+		: m_pWindow{ pWindow }
+		, m_pFrontBuffer{ SDL_GetWindowSurface(pWindow) }
+	{
+		int width{};
+		int height{};
+		SDL_GetWindowSize(pWindow, &width, &height);
+
+		//The surfaces wrap pixels allocated here, rows are exactly width pixels as FrameTarget promises
+		for (SDL_Surface*& pBackBuffer : m_pBackBuffers)
+		{
+			uint32_t* pPixels{ new uint32_t[width * height] };
+			pBackBuffer = SDL_CreateRGBSurfaceWithFormatFrom(pPixels, width, height, 32, width * static_cast<int>(sizeof(uint32_t)), SDL_PIXELFORMAT_RGBA32);
+		}
+
+		m_PresentThread = std::thread{ &FramePresenter::PresentLoop, this };
+	}
+
+	FramePresenter::~FramePresenter()
+	{
+		WaitUntilIdle();
+
+		m_SubmittedFrames.store(STOP_FRAME, std::memory_order_release);
+		m_SubmittedFrames.notify_one();
+		m_PresentThread.join();
+
+		for (SDL_Surface* pBackBuffer : m_pBackBuffers)
+		{
+			uint32_t* pPixels{ static_cast<uint32_t*>(pBackBuffer->pixels) };
+			SDL_FreeSurface(pBackBuffer);
+			delete[] pPixels;
+		}
+	}
+
+	uint32_t* FramePresenter::AcquireFrame()
+	{
+		//Frame n reuses the buffer of frame n - BUFFER_COUNT, which has to be on the window by now
+		const uint64_t frame{ m_SubmittedFrames.load(std::memory_order_relaxed) };
+		uint64_t presentedFrames{ m_PresentedFrames.load(std::memory_order_acquire) };
+		while (frame - presentedFrames >= BUFFER_COUNT)
+		{
+			m_PresentedFrames.wait(presentedFrames, std::memory_order_acquire);
+			presentedFrames = m_PresentedFrames.load(std::memory_order_acquire);
+		}
+
+		return static_cast<uint32_t*>(m_pBackBuffers[frame % BUFFER_COUNT]->pixels);
+	}
+
+	void FramePresenter::SubmitFrame()
+	{
+		const uint64_t frame{ m_SubmittedFrames.load(std::memory_order_relaxed) };
+		m_SubmitTimes[frame % BUFFER_COUNT] = std::chrono::steady_clock::now();
+
+		m_SubmittedFrames.store(frame + 1, std::memory_order_release);
+		m_SubmittedFrames.notify_one();
+	}
+
+	void FramePresenter::WaitUntilIdle()
+	{
+		const uint64_t submittedFrames{ m_SubmittedFrames.load(std::memory_order_relaxed) };
+		uint64_t presentedFrames{ m_PresentedFrames.load(std::memory_order_acquire) };
+		while (presentedFrames != submittedFrames)
+		{
+			m_PresentedFrames.wait(presentedFrames, std::memory_order_acquire);
+			presentedFrames = m_PresentedFrames.load(std::memory_order_acquire);
+		}
+	}
+
+	double FramePresenter::GetLastLatencyMs() const
+	{
+		return m_LastLatencyNanoseconds.load(std::memory_order_relaxed) / 1e6;
+	}
+
+	double FramePresenter::TakeMaxLatencyMs()
+	{
+		return m_MaxLatencyNanoseconds.exchange(0, std::memory_order_relaxed) / 1e6;
+	}
+
+	void FramePresenter::PresentLoop()
+	{
+		uint64_t presentedFrames{};
+		while (true)
+		{
+			uint64_t submittedFrames{ m_SubmittedFrames.load(std::memory_order_acquire) };
+			while (submittedFrames == presentedFrames)
+			{
+				m_SubmittedFrames.wait(submittedFrames, std::memory_order_acquire);
+				submittedFrames = m_SubmittedFrames.load(std::memory_order_acquire);
+			}
+			if (submittedFrames == STOP_FRAME)
+				return;
+
+			const int bufferIdx{ static_cast<int>(presentedFrames % BUFFER_COUNT) };
+			SDL_BlitSurface(m_pBackBuffers[bufferIdx], 0, m_pFrontBuffer, 0);
+			SDL_UpdateWindowSurface(m_pWindow);
+
+			const uint64_t latency{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - m_SubmitTimes[bufferIdx]).count()) };
+			m_LastLatencyNanoseconds.store(latency, std::memory_order_relaxed);
+			uint64_t maxLatency{ m_MaxLatencyNanoseconds.load(std::memory_order_relaxed) };
+			while (latency > maxLatency && !m_MaxLatencyNanoseconds.compare_exchange_weak(maxLatency, latency, std::memory_order_relaxed))
+			{
+			}
+
+			m_PresentedFrames.store(++presentedFrames, std::memory_order_release);
+			m_PresentedFrames.notify_one();
+		}
+	}
+}
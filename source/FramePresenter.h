@@ -0,0 +1,67 @@
+#pragma once
+#include "FrameTarget.h"
+
+//Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+struct SDL_Window;
+struct SDL_Surface;
+
+namespace dae
+{
+	//Presents software frames on a thread of its own: the render thread hands over a finished back buffer and rasterizes
+	//the next frame into the other one while this one is blitted. The handoff is two frame counters, no locks.
+	//The render thread never gets more than one frame ahead, so a frame is on the window at most one frame after SubmitFrame
+	class FramePresenter final : public FrameTarget
+	{
+	public:
+		static constexpr int BUFFER_COUNT{ 2 };
+
+		//The back buffers are RGBA32 surfaces of the window size
+		explicit FramePresenter(SDL_Window* pWindow);
+		//Presents every frame that was already submitted
+		~FramePresenter() override;
+
+		FramePresenter(const FramePresenter&) = delete;
+		FramePresenter(FramePresenter&&) noexcept = delete;
+		FramePresenter& operator=(const FramePresenter&) = delete;
+		FramePresenter& operator=(FramePresenter&&) noexcept = delete;
+
+		//Back buffer the next frame is drawn into, waits while the present thread still reads it.
+		//Render thread only, like SubmitFrame and WaitUntilIdle
+		uint32_t* AcquireFrame() override;
+		//Hands the buffer of the last AcquireFrame to the present thread
+		void SubmitFrame() override;
+		//Returns once every submitted frame is on the window, before something else draws to it
+		void WaitUntilIdle();
+
+		//Time from SubmitFrame until the window was updated: of the last presented frame, and the worst since the previous call
+		double GetLastLatencyMs() const;
+		double TakeMaxLatencyMs();
+
+	private:
+		//Stored in m_SubmittedFrames to stop the present thread
+		static constexpr uint64_t STOP_FRAME{ UINT64_MAX };
+
+		void PresentLoop();
+
+		SDL_Window* m_pWindow;
+		SDL_Surface* m_pFrontBuffer;
+		SDL_Surface* m_pBackBuffers[BUFFER_COUNT];
+
+		//Frame n is drawn into back buffer n % BUFFER_COUNT. Only the render thread writes m_SubmittedFrames
+		//and only the present thread writes m_PresentedFrames, each side waits on the counter of the other
+		std::atomic<uint64_t> m_SubmittedFrames{};
+		std::atomic<uint64_t> m_PresentedFrames{};
+		//Written before the frame is published, read by the present thread after it sees the new count
+		std::chrono::steady_clock::time_point m_SubmitTimes[BUFFER_COUNT]{};
+
+		std::atomic<uint64_t> m_LastLatencyNanoseconds{};
+		std::atomic<uint64_t> m_MaxLatencyNanoseconds{};
+
+		std::thread m_PresentThread{};
+	};
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+//Standard includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace dae
+{
+	//Parts of a software frame that are timed separately. Clear, Rasterization and Pack run per tile on every
+	//thread of the pool, their times are summed over the threads; the others run on the render thread.
+	//Present is only the handoff to the present thread, including the wait for a free back buffer
+	enum class FrameStage
+	{
+		Clear,
+		VertexTransformation,
+		TriangleSetup,
+		Binning,
+		Rasterization,
+		Pack,
+		Present,
+
+		END
+	};
+
+	//Counters of one software frame, threads accumulate locally and add once per triangle or tile
+	struct FrameStats
+	{
+		//Triangles that reached setup, and the ones of those dropped by backface culling
+		std::atomic<uint64_t> setupTriangles{};
+		std::atomic<uint64_t> culledTriangles{};
+		//Block classification of the rasterizer, HiZ rejected blocks are not classified
+		std::atomic<uint64_t> rejectedBlocks{};
+		std::atomic<uint64_t> acceptedBlocks{};
+		std::atomic<uint64_t> partialBlocks{};
+		//Fragments that passed the depth test when drawn, what immediate mode shades
+		std::atomic<uint64_t> depthPassedFragments{};
+		//PixelShading invocations actually done
+		std::atomic<uint64_t> shadedFragments{};
+		//Calls to operator new during the frame, zero once every buffer has grown to its steady state size.
+		//Always zero unless built with DAE_COUNT_ALLOCATIONS (see AllocationCounter.h)
+		std::atomic<uint64_t> heapAllocations{};
+		//Nanoseconds spent in every FrameStage
+		std::atomic<uint64_t> stageNanoseconds[static_cast<int>(FrameStage::END)]{};
+
+		void AddStageTime(FrameStage stage, std::chrono::steady_clock::duration time)
+		{
+			stageNanoseconds[static_cast<int>(stage)].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count(), std::memory_order_relaxed);
+		}
+
+		void Reset()
+		{
+			setupTriangles.store(0, std::memory_order_relaxed);
+			culledTriangles.store(0, std::memory_order_relaxed);
+			rejectedBlocks.store(0, std::memory_order_relaxed);
+			acceptedBlocks.store(0, std::memory_order_relaxed);
+			partialBlocks.store(0, std::memory_order_relaxed);
+			depthPassedFragments.store(0, std::memory_order_relaxed);
+			shadedFragments.store(0, std::memory_order_relaxed);
+			heapAllocations.store(0, std::memory_order_relaxed);
+			for (std::atomic<uint64_t>& nanoseconds : stageNanoseconds)
+				nanoseconds.store(0, std::memory_order_relaxed);
+		}
+	};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+//Standard includes
+#include <cstdint>
+#include <vector>
+
+namespace dae
+{
+	//Where the software backend draws its frames: width x height RGBA32 pixels (R in the lowest byte),
+	//rows width pixels apart. Every frame is one AcquireFrame followed by one SubmitFrame on the render thread
+	class FrameTarget
+	{
+	public:
+		FrameTarget() = default;
+		virtual ~FrameTarget() = default;
+
+		FrameTarget(const FrameTarget&) = delete;
+		FrameTarget(FrameTarget&&) noexcept = delete;
+		FrameTarget& operator=(const FrameTarget&) = delete;
+		FrameTarget& operator=(FrameTarget&&) noexcept = delete;
+
+		//Pixels of the next frame, may wait until they are free again. Stays valid until the next AcquireFrame
+		virtual uint32_t* AcquireFrame() = 0;
+		//The pixels of the last AcquireFrame hold a finished frame
+		virtual void SubmitFrame() = 0;
+	};
+
+	//A single frame in memory that every frame is drawn into, for headless runs and benchmarks.
+	//A submitted frame stays there until the next AcquireFrame
+	class MemoryFrameTarget final : public FrameTarget
+	{
+	public:
+		MemoryFrameTarget(int width, int height)
+			: m_Pixels(static_cast<size_t>(width) * height)
+		{
+		}
+
+		uint32_t* AcquireFrame() override { return m_Pixels.data(); }
+		void SubmitFrame() override {}
+
+	private:
+		std::vector<uint32_t> m_Pixels;
+	};
+}
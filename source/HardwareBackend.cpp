@@ -0,0 +1,300 @@
+#include "pch.h"
+#include "HardwareBackend.h"
+#include "MeshShaderEffect.h"
+
+namespace dae
+{
+	HardwareBackend::HardwareBackend(SDL_Window* pWindow, int width, int height) :
+		m_pWindow(pWindow),
+		m_Width(width),
+		m_Height(height)
+	{
+		const HRESULT result = InitializeDirectX();
+
+		if (result == S_OK)
+		{
+			m_IsInitialized = true;
+			std::cout << "DirectX is initialized and ready!\n";
+
+		}
+		else
+		{
+			std::cout << "DirectX initialization failed!\n";
+		}
+	}
+
+	HardwareBackend::~HardwareBackend()
+	{
+		if (m_pDeviceContext)
+		{
+			m_pDeviceContext->ClearState();
+			m_pDeviceContext->Flush();
+			m_pDeviceContext->Release();
+		}
+
+		for (const auto& [pMesh, pHardwareMesh] : m_Meshes)
+			delete pHardwareMesh;
+		m_Meshes.clear();
+
+		for (const auto& [pTexture, pHardwareTexture] : m_Textures)
+			delete pHardwareTexture;
+		m_Textures.clear();
+
+		if (m_pRasterizerState)
+			m_pRasterizerState->Release();
+		if (m_pRenderTargetView)
+			m_pRenderTargetView->Release();
+		if (m_pRenderTargetBuffer)
+			m_pRenderTargetBuffer->Release();
+		if (m_pDepthStencilView)
+			m_pDepthStencilView->Release();
+		if (m_pDepthStencilBuffer)
+			m_pDepthStencilBuffer->Release();
+		if (m_pSwapChain)
+			m_pSwapChain->Release();
+		if (m_pDevice)
+			m_pDevice->Release();
+	}
+
+	void HardwareBackend::AddMesh(const Mesh* pMesh, HardwareMesh* pHardwareMesh)
+	{
+		m_Meshes[pMesh] = pHardwareMesh;
+	}
+
+	void HardwareBackend::AddTexture(const Texture* pTexture, HardwareTexture* pHardwareTexture)
+	{
+		m_Textures[pTexture] = pHardwareTexture;
+	}
+
+	void HardwareBackend::RemoveTexture(const Texture* pTexture)
+	{
+		const auto it{ m_Textures.find(pTexture) };
+		if (it == m_Textures.end())
+			return;
+
+		//Effect variables keep a reference of their own until the next frame binds the replacement
+		delete it->second;
+		m_Textures.erase(it);
+	}
+
+	void HardwareBackend::SwitchTechnique()
+	{
+		for (const auto& [pMesh, pHardwareMesh] : m_Meshes)
+			pHardwareMesh->GetEffect()->SwitchCurrentTechnique();
+	}
+
+	void HardwareBackend::Render(const Scene& scene)
+	{
+		if (!m_IsInitialized)
+			return;
+
+		ColorRGB clearColor{ 135.f / 255.f, 206.f / 255.f, 235.f / 255.f };
+		//1. CLEAR RTV & DSV
+		if (scene.isClearColorToggled)
+			clearColor = { 0.f, 0.f, 0.f };
+
+		m_pDeviceContext->ClearRenderTargetView(m_pRenderTargetView, &clearColor.r);
+		m_pDeviceContext->ClearDepthStencilView(m_pDepthStencilView, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.f, 0);
+
+		//2. SET PIPELINE + INVOKE DRAWCALLS (=RENDER)
+		UpdateRasterizerState(scene.cullMode);
+
+		//The transparent object is drawn with the matrix of the opaque one, so it waits for the opaque one as well
+		if (HardwareMesh* pOpaqueMesh{ FindMesh(scene.opaque.pMesh) })
+		{
+			const Matrix worldMatrix{ scene.opaque.pMesh->GetWorldMatrix() };
+			auto worldViewProjectionMatix = worldMatrix * scene.viewMatrix * scene.projectionMatrix;
+
+			if (m_pRasterizerState)
+				pOpaqueMesh->GetEffect()->SetRasterizerState(m_pRasterizerState);
+			BindMaterial(pOpaqueMesh->GetEffect(), scene.opaque.material);
+			pOpaqueMesh->Render(m_pDeviceContext, worldViewProjectionMatix, worldMatrix, scene.invViewMatrix);
+
+			if (HardwareMesh* pTransparentMesh{ FindMesh(scene.transparent.pMesh) })
+			{
+				BindMaterial(pTransparentMesh->GetEffect(), scene.transparent.material);
+				pTransparentMesh->Render(m_pDeviceContext, worldViewProjectionMatix, scene.transparent.pMesh->GetWorldMatrix(), scene.invViewMatrix);
+			}
+		}
+
+		//3. PRESENT BACKBUFFER (SWAP)
+		m_pSwapChain->Present(0, 0);
+
+	}
+
+	void HardwareBackend::UpdateRasterizerState(CullFaceMode cullMode)
+	{
+		if (cullMode == m_RasterizerCullMode)
+			return;
+		m_RasterizerCullMode = cullMode;
+
+		D3D11_RASTERIZER_DESC rasterizerDesc;
+		rasterizerDesc.AntialiasedLineEnable = false;
+		rasterizerDesc.MultisampleEnable = false;
+		rasterizerDesc.ScissorEnable = false;
+		rasterizerDesc.DepthClipEnable = true;
+		rasterizerDesc.DepthBiasClamp = 0.f;
+		rasterizerDesc.SlopeScaledDepthBias = 0.f;
+		rasterizerDesc.DepthBias = 0;
+		rasterizerDesc.FrontCounterClockwise = false;
+		rasterizerDesc.FillMode = D3D11_FILL_SOLID;
+
+
+		switch (cullMode)
+		{
+		case dae::CullFaceMode::Front:
+			rasterizerDesc.CullMode = D3D11_CULL_MODE::D3D11_CULL_FRONT;
+			break;
+		case dae::CullFaceMode::Back:
+			rasterizerDesc.CullMode = D3D11_CULL_MODE::D3D11_CULL_BACK;
+			break;
+		default:
+			rasterizerDesc.CullMode = D3D11_CULL_MODE::D3D11_CULL_NONE;
+			break;
+		}
+
+		if (m_pRasterizerState)
+			m_pRasterizerState->Release();
+
+		m_pDevice->CreateRasterizerState(&rasterizerDesc, &m_pRasterizerState);
+	}
+
+	HardwareMesh* HardwareBackend::FindMesh(const Mesh* pMesh) const
+	{
+		const auto it{ m_Meshes.find(pMesh) };
+		return it != m_Meshes.end() ? it->second : nullptr;
+	}
+
+	const HardwareTexture* HardwareBackend::FindTexture(const Texture* pTexture) const
+	{
+		const auto it{ m_Textures.find(pTexture) };
+		return it != m_Textures.end() ? it->second : nullptr;
+	}
+
+	void HardwareBackend::BindMaterial(Effect* pEffect, const Material& material) const
+	{
+		//Textures without a GPU copy keep whatever the effect had bound before
+		if (const HardwareTexture* pDiffuse{ FindTexture(material.pDiffuse) })
+			pEffect->SetDiffuseMap(pDiffuse);
+
+		//Only the mesh shader samples the other maps
+		MeshShaderEffect* pShaderEffect{ dynamic_cast<MeshShaderEffect*>(pEffect) };
+		if (pShaderEffect == nullptr)
+			return;
+
+		if (const HardwareTexture* pNormal{ FindTexture(material.pNormal) })
+			pShaderEffect->SetNormalMap(pNormal);
+
+		if (const HardwareTexture* pGlossiness{ FindTexture(material.pGlossiness) })
+			pShaderEffect->SetGlossinessMap(pGlossiness);
+
+		if (const HardwareTexture* pSpecular{ FindTexture(material.pSpecular) })
+			pShaderEffect->SetSpecularMap(pSpecular);
+	}
+
+	HRESULT HardwareBackend::InitializeDirectX()
+	{
+		//1. Create Device & DeviceContext
+		D3D_FEATURE_LEVEL featureLevel = D3D_FEATURE_LEVEL_11_1;
+		uint32_t createDeviceFlags = 0;
+#if defined(DEBUG) || defined(_DEBUG)
+		createDeviceFlags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+		HRESULT result = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, 0, createDeviceFlags, &featureLevel, 1, D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
+
+		if (FAILED(result))
+			return result;
+
+		//Create DXGI Factory
+		IDXGIFactory1* pDxgiFactory{};
+		result = CreateDXGIFactory1(__uuidof(IDXGIFactory1), reinterpret_cast<void**>(&pDxgiFactory));
+
+		if (FAILED(result))
+			return result;
+
+		//2. Create Swapchain
+		DXGI_SWAP_CHAIN_DESC swapChainDesc{};
+		swapChainDesc.BufferDesc.Width = m_Width;
+		swapChainDesc.BufferDesc.Height = m_Height;
+		swapChainDesc.BufferDesc.RefreshRate.Numerator = 1;
+		swapChainDesc.BufferDesc.RefreshRate.Denominator = 60;
+		swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+		swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+		swapChainDesc.SampleDesc.Count = 1;
+		swapChainDesc.SampleDesc.Quality = 0;
+		swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		swapChainDesc.BufferCount = 1;
+		swapChainDesc.Windowed = true;
+		swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_DISCARD;
+		swapChainDesc.Flags = 0;
+
+		//Get the handle (HWND) from the SDL Backbuffer
+		SDL_SysWMinfo sysWMInfo{};
+		SDL_VERSION(&sysWMInfo.version);
+		SDL_GetWindowWMInfo(m_pWindow, &sysWMInfo);
+		swapChainDesc.OutputWindow = sysWMInfo.info.win.window;
+
+		//Create SwapChain
+		result = pDxgiFactory->CreateSwapChain(m_pDevice, &swapChainDesc, &m_pSwapChain);
+
+		if (FAILED(result))
+			return result;
+
+		//3. Create DepthStencil (DS) & DepthStencilView (DSV)
+
+		D3D11_TEXTURE2D_DESC depthStencilDesc{};
+		depthStencilDesc.Width = m_Width;
+		depthStencilDesc.Height = m_Height;
+		depthStencilDesc.MipLevels = 1;
+		depthStencilDesc.ArraySize = 1;
+		depthStencilDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+		depthStencilDesc.SampleDesc.Count = 1;
+		depthStencilDesc.SampleDesc.Quality = 0;
+		depthStencilDesc.Usage = D3D11_USAGE_DEFAULT;
+		depthStencilDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+		depthStencilDesc.CPUAccessFlags = 0;
+		depthStencilDesc.MiscFlags = 0;
+
+
+		//View
+		D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDesc{};
+		depthStencilViewDesc.Format = depthStencilDesc.Format;
+		depthStencilViewDesc.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+		depthStencilViewDesc.Texture2D.MipSlice = 0;
+
+		result = m_pDevice->CreateTexture2D(&depthStencilDesc, nullptr, &m_pDepthStencilBuffer);
+		if (FAILED(result))
+			return result;
+
+		result = m_pDevice->CreateDepthStencilView(m_pDepthStencilBuffer, &depthStencilViewDesc, &m_pDepthStencilView);
+		if (FAILED(result))
+			return result;
+
+		//4. Create renderTarget (RT) & RenderTargetView (RTV)
+
+		//Resource 
+		result = m_pSwapChain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&m_pRenderTargetBuffer));
+		if (FAILED(result))
+			return result;
+
+		//View
+		result = m_pDevice->CreateRenderTargetView(m_pRenderTargetBuffer, nullptr, &m_pRenderTargetView);
+
+		//5. Bind RTV & DSV to output Merger Stage
+		m_pDeviceContext->OMSetRenderTargets(1, &m_pRenderTargetView, m_pDepthStencilView);
+
+		//6. Set viewport
+		D3D11_VIEWPORT viewPort{};
+		viewPort.Width = static_cast<float>(m_Width);
+		viewPort.Height = static_cast<float>(m_Height);
+		viewPort.TopLeftX = 0.f;
+		viewPort.TopLeftY = 0.f;
+		viewPort.MinDepth = 0.f;
+		viewPort.MaxDepth = 1.f;
+		m_pDeviceContext->RSSetViewports(1, &viewPort);
+		
+		pDxgiFactory->Release();
+		return S_OK;
+	}
+}
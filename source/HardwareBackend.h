@@ -0,0 +1,69 @@
+#pragma once
+#include "pch.h"
+#include "RenderBackend.h"
+#include "HardwareMesh.h"
+#include "HardwareTexture.h"
+
+//Standard includes
+#include <unordered_map>
+
+struct SDL_Window;
+
+namespace dae
+{
+	//Direct3D 11 on the swap chain of the window. Scenes refer to CPU meshes and textures,
+	//the backend looks up the GPU copies it was handed for them with AddMesh and AddTexture
+	class HardwareBackend final : public RenderBackend
+	{
+	public:
+		HardwareBackend(SDL_Window* pWindow, int width, int height);
+		~HardwareBackend() override;
+
+		HardwareBackend(const HardwareBackend&) = delete;
+		HardwareBackend(HardwareBackend&&) noexcept = delete;
+		HardwareBackend& operator=(const HardwareBackend&) = delete;
+		HardwareBackend& operator=(HardwareBackend&&) noexcept = delete;
+
+		//False when DirectX could not be set up, Render does nothing then
+		bool IsInitialized() const { return m_IsInitialized; }
+		//Free threaded, the asset loader creates the GPU copies with it
+		ID3D11Device* GetDevice() const { return m_pDevice; }
+
+		//Takes ownership of the GPU copy, objects without one are skipped
+		void AddMesh(const Mesh* pMesh, HardwareMesh* pHardwareMesh);
+		void AddTexture(const Texture* pTexture, HardwareTexture* pHardwareTexture);
+		//Deletes the GPU copy, before the CPU texture goes away
+		void RemoveTexture(const Texture* pTexture);
+
+		void SwitchTechnique();
+		void Render(const Scene& scene) override;
+
+	private:
+		bool m_IsInitialized{ false };
+
+		SDL_Window* m_pWindow;
+		int m_Width;
+		int m_Height;
+
+		//DIRECTX
+		ID3D11Device* m_pDevice{ nullptr };
+		ID3D11DeviceContext* m_pDeviceContext{ nullptr };
+		IDXGISwapChain* m_pSwapChain{ nullptr };
+		ID3D11Texture2D* m_pDepthStencilBuffer{ nullptr };
+		ID3D11DepthStencilView* m_pDepthStencilView{ nullptr };
+		ID3D11Resource* m_pRenderTargetBuffer{ nullptr };
+		ID3D11RenderTargetView* m_pRenderTargetView{ nullptr };
+		//nullptr until the scene asks for another cull mode than the one the effects start with
+		ID3D11RasterizerState* m_pRasterizerState{ nullptr };
+		CullFaceMode m_RasterizerCullMode{ CullFaceMode::None };
+
+		std::unordered_map<const Mesh*, HardwareMesh*> m_Meshes{};
+		std::unordered_map<const Texture*, HardwareTexture*> m_Textures{};
+
+		HRESULT InitializeDirectX();
+		void UpdateRasterizerState(CullFaceMode cullMode);
+		HardwareMesh* FindMesh(const Mesh* pMesh) const;
+		const HardwareTexture* FindTexture(const Texture* pTexture) const;
+		void BindMaterial(Effect* pEffect, const Material& material) const;
+	};
+}
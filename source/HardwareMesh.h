@@ -0,0 +1,155 @@
+#pragma once
+#include "pch.h"
+#include "Effect.h"
+#include "Mesh.h"
+
+namespace dae
+{
+	//GPU side of a Mesh: vertex and index buffers, input layout and the effect it is drawn with
+	class HardwareMesh final
+	{
+	public:
+		//Takes ownership of pEffect, the buffers are filled from the mesh, which may be released afterwards
+		HardwareMesh(ID3D11Device* pDevice, const Mesh& mesh, Effect* pEffect)
+			: m_NumIndices{ mesh.GetIndices().size() }
+			, m_pEffect{ pEffect }
+		{
+			CreateBuffers(pDevice, mesh);
+		}
+
+		~HardwareMesh()
+		{
+
+			delete m_pEffect;
+			m_pEffect = nullptr;
+			if (m_pIndexBuffer != nullptr)
+			{
+				m_pIndexBuffer->Release();
+			}
+
+			if (m_pVertexBuffer != nullptr)
+			{
+				m_pVertexBuffer->Release();
+			}
+			if (m_pInputLayout != nullptr)
+			{
+				m_pInputLayout->Release();
+			}
+		}
+
+		HardwareMesh(const HardwareMesh&) = delete;
+		HardwareMesh(HardwareMesh&&) noexcept = delete;
+		HardwareMesh& operator=(const HardwareMesh&) = delete;
+		HardwareMesh& operator=(HardwareMesh&&) noexcept = delete;
+
+		void Render(ID3D11DeviceContext* pDeviceContext, Matrix worldViewProjectionMatrix, Matrix worldMatrix, Matrix invViewMatrix)
+		{
+			m_pEffect->SetWorldViewProjMatrixData(worldViewProjectionMatrix);
+			m_pEffect->SetWorldMatrixData(worldMatrix);
+			m_pEffect->SetInvViewMatrixData(invViewMatrix);
+
+
+			//1. Set Primitive Topology
+			pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+			//2. Set Input Layout
+			pDeviceContext->IASetInputLayout(m_pInputLayout);
+		
+			//3. Set VertexBuffer
+			constexpr UINT stride = sizeof(Vertex);
+			constexpr UINT offset = 0;
+			pDeviceContext->IASetVertexBuffers(0, 1, &m_pVertexBuffer, &stride, &offset);
+				
+			//4. Set IndexBuffer
+			pDeviceContext->IASetIndexBuffer(m_pIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+
+
+			//5. Draw
+			D3DX11_TECHNIQUE_DESC techDesc;
+			m_pEffect->GetTechnique()->GetDesc(&techDesc);
+			for (UINT p = 0; p < techDesc.Passes; ++p)
+			{
+				m_pEffect->GetTechnique()->GetPassByIndex(p)->Apply(0, pDeviceContext);
+				pDeviceContext->DrawIndexed(UINT(m_NumIndices), UINT(0), INT(0));
+			}
+		}
+
+		Effect* GetEffect() const { return m_pEffect; }
+
+	private:
+		void CreateBuffers(ID3D11Device* pDevice, const Mesh& mesh)
+		{
+			//Create Vertex Layout
+			static constexpr uint32_t numElements{ 5 };
+			D3D11_INPUT_ELEMENT_DESC vertexDesc[numElements]{};
+
+			vertexDesc[0].SemanticName = "POSITION";
+			vertexDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+			vertexDesc[0].AlignedByteOffset = 0;
+			vertexDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+			vertexDesc[1].SemanticName = "COLOR";
+			vertexDesc[1].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+			vertexDesc[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+			vertexDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+			vertexDesc[2].SemanticName = "TEXCOORD";
+			vertexDesc[2].Format = DXGI_FORMAT_R32G32_FLOAT;
+			vertexDesc[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+			vertexDesc[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+			vertexDesc[3].SemanticName = "NORMAL";
+			vertexDesc[3].Format = DXGI_FORMAT_R32G32_FLOAT;
+			vertexDesc[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+			vertexDesc[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+			vertexDesc[4].SemanticName = "TANGENT";
+			vertexDesc[4].Format = DXGI_FORMAT_R32G32_FLOAT;
+			vertexDesc[4].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+			vertexDesc[4].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+
+			//Create input Layout
+			D3DX11_PASS_DESC passDesc{};
+			m_pEffect->GetTechnique()->GetPassByIndex(0)->GetDesc(&passDesc);
+
+			HRESULT result = pDevice->CreateInputLayout(
+				vertexDesc,
+				numElements,
+				passDesc.pIAInputSignature,
+				passDesc.IAInputSignatureSize,
+				&m_pInputLayout);
+
+			//Create vertex buffer
+			D3D11_BUFFER_DESC bd = {};
+			bd.Usage = D3D11_USAGE_IMMUTABLE;
+			bd.ByteWidth = sizeof(Vertex) * static_cast<uint32_t>(mesh.GetVertices().size());
+			bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+			bd.CPUAccessFlags = 0;
+			bd.MiscFlags = 0;
+
+			D3D11_SUBRESOURCE_DATA initData = {};
+			initData.pSysMem = mesh.GetVertices().data();
+
+			result = pDevice->CreateBuffer(&bd, &initData, &m_pVertexBuffer);
+			if (FAILED(result))
+				return;
+
+			//Create index buffer 
+			bd.Usage = D3D11_USAGE_IMMUTABLE;
+			bd.ByteWidth = UINT(sizeof(uint32_t) * m_NumIndices);
+			bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+			bd.CPUAccessFlags = 0;
+			bd.MiscFlags = 0;
+			initData.pSysMem = mesh.GetIndices().data();
+			result = pDevice->CreateBuffer(&bd, &initData, &m_pIndexBuffer);
+			if (FAILED(result))
+				return;
+		}
+
+		ID3D11InputLayout* m_pInputLayout{ nullptr };
+		ID3D11Buffer* m_pVertexBuffer{ nullptr };
+		ID3D11Buffer* m_pIndexBuffer{ nullptr };
+		size_t m_NumIndices;
+		Effect* m_pEffect;
+	};
+}
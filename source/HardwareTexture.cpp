@@ -0,0 +1,57 @@
+#include "pch.h"
+#include "HardwareTexture.h"
+
+namespace dae
+{
+	HardwareTexture* HardwareTexture::Create(const Texture& texture, ID3D11Device* pDevice)
+	{
+		HardwareTexture* returnTexture{ new HardwareTexture{} };
+
+		DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		D3D11_TEXTURE2D_DESC desc{};
+		desc.Width = static_cast<UINT>(texture.GetWidth());
+		desc.Height = static_cast<UINT>(texture.GetHeight());
+		desc.MipLevels = static_cast<UINT>(texture.GetNumMipLevels());
+		desc.ArraySize = 1;
+		desc.Format = format;
+		desc.SampleDesc.Count = 1;
+		desc.SampleDesc.Quality = 0;
+		desc.Usage = D3D11_USAGE_DEFAULT;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+		desc.CPUAccessFlags = 0;
+		desc.MiscFlags = 0;
+
+
+		//The hardware samplers get the same mip chain as the software one
+		std::vector<D3D11_SUBRESOURCE_DATA> initData(texture.GetNumMipLevels());
+		for (size_t level{}; level < initData.size(); ++level)
+		{
+			const Texture::MipLevel& mipLevel{ texture.GetMipLevel(level) };
+			initData[level].pSysMem = mipLevel.pTexels;
+			initData[level].SysMemPitch = static_cast<UINT>(mipLevel.rowStride * sizeof(uint32_t));
+			initData[level].SysMemSlicePitch = static_cast<UINT>(mipLevel.rowStride * sizeof(uint32_t) * mipLevel.height);
+		}
+
+		HRESULT result = pDevice->CreateTexture2D(&desc, initData.data(), &returnTexture->m_pResource);
+
+		if (FAILED(result))
+		{
+			delete returnTexture;
+			return nullptr;
+		}
+
+		D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
+		SRVDesc.Format = format;
+		SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		SRVDesc.Texture2D.MipLevels = desc.MipLevels;
+
+		result = pDevice->CreateShaderResourceView(returnTexture->m_pResource, &SRVDesc, &returnTexture->m_pSRV);
+		if (FAILED(result))
+		{
+			delete returnTexture;
+			return nullptr;
+		}
+
+		return returnTexture;
+	}
+}
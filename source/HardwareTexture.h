@@ -0,0 +1,43 @@
+#pragma once
+#include "pch.h"
+#include "Texture.h"
+
+namespace dae
+{
+	//GPU side of a Texture: the linear mip chain uploaded once, and the view the effects sample it through
+	class HardwareTexture final
+	{
+	public:
+		//Uploads every level of the texture, nullptr when the device refuses it. The device is free threaded,
+		//so this runs on the loader threads
+		static HardwareTexture* Create(const Texture& texture, ID3D11Device* pDevice);
+
+		~HardwareTexture()
+		{
+			if (m_pSRV != nullptr)
+			{
+				m_pSRV->Release();
+				m_pSRV = nullptr;
+			}
+
+			if (m_pResource != nullptr)
+			{
+				m_pResource->Release();
+				m_pResource = nullptr;
+			}
+		}
+
+		HardwareTexture(const HardwareTexture&) = delete;
+		HardwareTexture(HardwareTexture&&) noexcept = delete;
+		HardwareTexture& operator=(const HardwareTexture&) = delete;
+		HardwareTexture& operator=(HardwareTexture&&) noexcept = delete;
+
+		ID3D11ShaderResourceView* GetSRV() const { return m_pSRV; }
+
+	private:
+		HardwareTexture() = default;
+
+		ID3D11ShaderResourceView* m_pSRV{ nullptr };
+		ID3D11Texture2D* m_pResource{ nullptr };
+	};
+}
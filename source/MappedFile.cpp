@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dae
+{
+#ifdef _WIN32
+	MappedFile::MappedFile(const std::string& filename)
+	{
+		HANDLE file{ CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		m_FileHandle = file;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize))
+			return;
+
+		m_Size = static_cast<size_t>(fileSize.QuadPart);
+		if (m_Size == 0)
+		{
+			//Zero sized files cannot be mapped
+			m_IsValid = true;
+			return;
+		}
+
+		m_MappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!m_MappingHandle)
+			return;
+
+		m_pData = static_cast<const char*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+		m_IsValid = m_pData != nullptr;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_pData)
+			UnmapViewOfFile(m_pData);
+		if (m_MappingHandle)
+			CloseHandle(m_MappingHandle);
+		if (m_FileHandle)
+			CloseHandle(m_FileHandle);
+	}
+#else
+	MappedFile::MappedFile(const std::string& filename)
+	{
+		const int file{ open(filename.c_str(), O_RDONLY) };
+		if (file < 0)
+			return;
+
+		struct stat fileStat{};
+		if (fstat(file, &fileStat) == 0)
+		{
+			m_Size = static_cast<size_t>(fileStat.st_size);
+			if (m_Size == 0)
+			{
+				m_IsValid = true;
+			}
+			else
+			{
+				void* pMapping{ mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0) };
+				if (pMapping != MAP_FAILED)
+				{
+					madvise(pMapping, m_Size, MADV_SEQUENTIAL);
+					m_pData = static_cast<const char*>(pMapping);
+					m_IsValid = true;
+				}
+			}
+		}
+
+		//The mapping keeps the file alive on its own
+		close(file);
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_pData)
+			munmap(const_cast<char*>(m_pData), m_Size);
+	}
+#endif
+}
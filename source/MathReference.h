@@ -0,0 +1,78 @@
+#pragma once
+#include "Math.h"
+
+//Standard includes
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace dae
+{
+	//Scalar reference of the math library: the Matrix functions as they were in Matrix.cpp before the header-only
+	//SSE2 version, and the random inputs they are compared on. Shared by Benchmark::MathLibrary and tests/MathTests.cpp
+	namespace MathReference
+	{
+		inline Matrix Multiply(const Matrix& m1, const Matrix& m2)
+		{
+			Matrix columns{};
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				for (int c{ 0 }; c < 4; ++c)
+					columns[r][c] = m2[c][r];
+			}
+
+			Matrix result{};
+			for (int r{ 0 }; r < 4; ++r)
+			{
+				for (int c{ 0 }; c < 4; ++c)
+				{
+					const Vector4 row{ m1[r] };
+					const Vector4 column{ columns[c] };
+					result[r][c] = row.x * column.x + row.y * column.y + row.z * column.z + row.w * column.w;
+				}
+			}
+			return result;
+		}
+
+		inline Vector4 TransformPoint(const Matrix& m, const Vector4& p)
+		{
+			return Vector4{
+				m[0].x * p.x + m[1].x * p.y + m[2].x * p.z + m[3].x,
+				m[0].y * p.x + m[1].y * p.y + m[2].y * p.z + m[3].y,
+				m[0].z * p.x + m[1].z * p.y + m[2].z * p.z + m[3].z,
+				m[0].w * p.x + m[1].w * p.y + m[2].w * p.z + m[3].w
+			};
+		}
+
+		inline Vector3 TransformVector(const Matrix& m, const Vector3& v)
+		{
+			return Vector3{
+				m[0].x * v.x + m[1].x * v.y + m[2].x * v.z,
+				m[0].y * v.x + m[1].y * v.y + m[2].y * v.z,
+				m[0].z * v.x + m[1].z * v.y + m[2].z * v.z
+			};
+		}
+
+		//Rotation, non uniform scale and translation, well conditioned so the Inverse residual measures rounding only
+		inline Matrix RandomMatrix(std::mt19937& generator)
+		{
+			std::uniform_real_distribution<float> angle{ -PI, PI };
+			std::uniform_real_distribution<float> scale{ 0.25f, 4.f };
+			std::uniform_real_distribution<float> translation{ -100.f, 100.f };
+
+			return Matrix::CreateScale(scale(generator), scale(generator), scale(generator))
+				* Matrix::CreateRotation(angle(generator), angle(generator), angle(generator))
+				* Matrix::CreateTranslation(translation(generator), translation(generator), translation(generator));
+		}
+
+		inline float MaxDifference(const Vector4& v1, const Vector4& v2)
+		{
+			return std::max({ std::abs(v1.x - v2.x), std::abs(v1.y - v2.y), std::abs(v1.z - v2.z), std::abs(v1.w - v2.w) });
+		}
+
+		inline float MaxDifference(const Matrix& m1, const Matrix& m2)
+		{
+			return std::max({ MaxDifference(m1[0], m2[0]), MaxDifference(m1[1], m2[1]), MaxDifference(m1[2], m2[2]), MaxDifference(m1[3], m2[3]) });
+		}
+	}
+}
@@ -1,8 +1,11 @@
 #pragma once
 #include "Vector3.h"
 #include "Vector4.h"
+#include "MathHelpers.h"
 
 namespace dae {
+	//Header only so the transforms inline into the pipeline. With SSE2 the transforms, the product and the transpose
+	//work on whole rows, in the same per component order as the scalar code, so both give bit-identical results
 	struct Matrix
 	{
 		Matrix() = default;
@@ -10,51 +13,174 @@ namespace dae {
 			const Vector3& xAxis,
 			const Vector3& yAxis,
 			const Vector3& zAxis,
-			const Vector3& t);
+			const Vector3& t) :
+			Matrix({ xAxis, 0 }, { yAxis, 0 }, { zAxis, 0 }, { t, 1 })
+		{
+		}
 
 		Matrix(
 			const Vector4& xAxis,
 			const Vector4& yAxis,
 			const Vector4& zAxis,
-			const Vector4& t);
+			const Vector4& t)
+		{
+			data[0] = xAxis;
+			data[1] = yAxis;
+			data[2] = zAxis;
+			data[3] = t;
+		}
+
+		Matrix(const Matrix& m) = default;
+		Matrix& operator=(const Matrix& m) = default;
 
-		Matrix(const Matrix& m);
+		Vector3 TransformVector(const Vector3& v) const
+		{
+			return TransformVector(v.x, v.y, v.z);
+		}
 
-		Vector3 TransformVector(const Vector3& v) const;
 		Vector3 TransformVector(float x, float y, float z) const;
-		Vector3 TransformPoint(const Vector3& p) const;
+
+		Vector3 TransformPoint(const Vector3& p) const
+		{
+			return TransformPoint(p.x, p.y, p.z);
+		}
+
 		Vector3 TransformPoint(float x, float y, float z) const;
 
-		Vector4 TransformPoint(const Vector4& p) const;
+		//Like the Vector3 version the translation row is added as is, w is taken to be 1
+		Vector4 TransformPoint(const Vector4& p) const
+		{
+			return TransformPoint(p.x, p.y, p.z, p.w);
+		}
+
 		Vector4 TransformPoint(float x, float y, float z, float w) const;
 
 		const Matrix& Transpose();
 		const Matrix& Inverse();
 
-		Vector3 GetAxisX() const;
-		Vector3 GetAxisY() const;
-		Vector3 GetAxisZ() const;
-		Vector3 GetTranslation() const;
-
-		static Matrix CreateTranslation(float x, float y, float z);
-		static Matrix CreateTranslation(const Vector3& t);
-		static Matrix CreateRotationX(float pitch);
-		static Matrix CreateRotationY(float yaw);
-		static Matrix CreateRotationZ(float roll);
-		static Matrix CreateRotation(float pitch, float yaw, float roll);
-		static Matrix CreateRotation(const Vector3& r);
-		static Matrix CreateScale(float sx, float sy, float sz);
-		static Matrix CreateScale(const Vector3& s);
-		static Matrix Transpose(const Matrix& m);
-		static Matrix Inverse(const Matrix& m);
-
-		static Matrix CreateLookAtLH(const Vector3& origin, const Vector3& forward, const Vector3& up);
-		static Matrix CreatePerspectiveFovLH(float fovy, float aspect, float zn, float zf);
-
-		Vector4& operator[](int index);
-		Vector4 operator[](int index) const;
+		Vector3 GetAxisX() const { return data[0]; }
+		Vector3 GetAxisY() const { return data[1]; }
+		Vector3 GetAxisZ() const { return data[2]; }
+		Vector3 GetTranslation() const { return data[3]; }
+
+		static Matrix CreateTranslation(float x, float y, float z)
+		{
+			return CreateTranslation({ x, y, z });
+		}
+
+		static Matrix CreateTranslation(const Vector3& t)
+		{
+			return { Vector3::UnitX, Vector3::UnitY, Vector3::UnitZ, t };
+		}
+
+		static Matrix CreateRotationX(float pitch)
+		{
+			return {
+				{1, 0, 0, 0},
+				{0, std::cos(pitch), -std::sin(pitch), 0},
+				{0, std::sin(pitch), std::cos(pitch), 0},
+				{0, 0, 0, 1}
+			};
+		}
+
+		static Matrix CreateRotationY(float yaw)
+		{
+			return {
+				{std::cos(yaw), 0, -std::sin(yaw), 0},
+				{0, 1, 0, 0},
+				{std::sin(yaw), 0, std::cos(yaw), 0},
+				{0, 0, 0, 1}
+			};
+		}
+
+		static Matrix CreateRotationZ(float roll)
+		{
+			return {
+				{std::cos(roll), std::sin(roll), 0, 0},
+				{-std::sin(roll), std::cos(roll), 0, 0},
+				{0, 0, 1, 0},
+				{0, 0, 0, 1}
+			};
+		}
+
+		static Matrix CreateRotation(float pitch, float yaw, float roll)
+		{
+			return CreateRotation({ pitch, yaw, roll });
+		}
+
+		static Matrix CreateRotation(const Vector3& r)
+		{
+			return CreateRotationX(r[0]) * CreateRotationY(r[1]) * CreateRotationZ(r[2]);
+		}
+
+		static Matrix CreateScale(float sx, float sy, float sz)
+		{
+			return { {sx, 0, 0}, {0, sy, 0}, {0, 0, sz}, Vector3::Zero };
+		}
+
+		static Matrix CreateScale(const Vector3& s)
+		{
+			return CreateScale(s[0], s[1], s[2]);
+		}
+
+		static Matrix Transpose(const Matrix& m)
+		{
+			Matrix out{ m };
+			out.Transpose();
+
+			return out;
+		}
+
+		static Matrix Inverse(const Matrix& m)
+		{
+			Matrix out{ m };
+			out.Inverse();
+
+			return out;
+		}
+
+		static Matrix CreateLookAtLH([[maybe_unused]] const Vector3& origin, [[maybe_unused]] const Vector3& forward, [[maybe_unused]] const Vector3& up)
+		{
+			assert(false && "Not Implemented");
+			return {};
+		}
+
+		static Matrix CreatePerspectiveFovLH(float fov, float aspect, float zn, float zf)
+		{
+
+			auto xScale = 1 / (fov * aspect);
+			auto yScale = 1 / fov;
+
+			//TODO W2
+			Matrix projectionMatrix{
+			   {xScale,     0,			  0,					0},
+			   {0,			yScale,       0,					0},
+			   {0,			0,			  zf / (zf - zn),		1},
+			   {0,			0,			    (- zn * zf) / (zf - zn),	0}
+			};
+
+			return projectionMatrix;
+		}
+
+		Vector4& operator[](int index)
+		{
+			assert(index <= 3 && index >= 0);
+			return data[index];
+		}
+
+		Vector4 operator[](int index) const
+		{
+			assert(index <= 3 && index >= 0);
+			return data[index];
+		}
+
 		Matrix operator*(const Matrix& m) const;
-		const Matrix& operator*=(const Matrix& m);
+
+		const Matrix& operator*=(const Matrix& m)
+		{
+			*this = *this * m;
+			return *this;
+		}
 
 	private:
 
@@ -72,4 +198,158 @@ namespace dae {
 		// v2x v2y v2z v2w
 		// v3x v3y v3z v3w
 	};
-}
\ No newline at end of file
+
+#if DAE_SIMD_SSE2
+	//Row vector times matrix: x * row0 + y * row1 + z * row2 (+ w * row3), summed in that order
+	inline Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+		const __m128 xy{ _mm_add_ps(_mm_mul_ps(Simd::Load(data[0]), _mm_set1_ps(x)), _mm_mul_ps(Simd::Load(data[1]), _mm_set1_ps(y))) };
+		const Vector4 result{ Simd::Store(_mm_add_ps(xy, _mm_mul_ps(Simd::Load(data[2]), _mm_set1_ps(z)))) };
+		return { result.x, result.y, result.z };
+	}
+
+	inline Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+		const __m128 xy{ _mm_add_ps(_mm_mul_ps(Simd::Load(data[0]), _mm_set1_ps(x)), _mm_mul_ps(Simd::Load(data[1]), _mm_set1_ps(y))) };
+		const __m128 xyz{ _mm_add_ps(xy, _mm_mul_ps(Simd::Load(data[2]), _mm_set1_ps(z))) };
+		const Vector4 result{ Simd::Store(_mm_add_ps(xyz, Simd::Load(data[3]))) };
+		return { result.x, result.y, result.z };
+	}
+
+	inline Vector4 Matrix::TransformPoint(float x, float y, float z, [[maybe_unused]] float w) const
+	{
+		const __m128 xy{ _mm_add_ps(_mm_mul_ps(Simd::Load(data[0]), _mm_set1_ps(x)), _mm_mul_ps(Simd::Load(data[1]), _mm_set1_ps(y))) };
+		const __m128 xyz{ _mm_add_ps(xy, _mm_mul_ps(Simd::Load(data[2]), _mm_set1_ps(z))) };
+		return Simd::Store(_mm_add_ps(xyz, Simd::Load(data[3])));
+	}
+
+	inline const Matrix& Matrix::Transpose()
+	{
+		__m128 row0{ Simd::Load(data[0]) };
+		__m128 row1{ Simd::Load(data[1]) };
+		__m128 row2{ Simd::Load(data[2]) };
+		__m128 row3{ Simd::Load(data[3]) };
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+		data[0] = Simd::Store(row0);
+		data[1] = Simd::Store(row1);
+		data[2] = Simd::Store(row2);
+		data[3] = Simd::Store(row3);
+
+		return *this;
+	}
+
+	//Row r of the product is row r of this matrix transforming the rows of m, the same sums as Dot(row, column)
+	inline Matrix Matrix::operator*(const Matrix& m) const
+	{
+		const __m128 otherRows[4]{ Simd::Load(m.data[0]), Simd::Load(m.data[1]), Simd::Load(m.data[2]), Simd::Load(m.data[3]) };
+
+		Matrix result;
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			const Vector4& row{ data[r] };
+			const __m128 xy{ _mm_add_ps(_mm_mul_ps(_mm_set1_ps(row.x), otherRows[0]), _mm_mul_ps(_mm_set1_ps(row.y), otherRows[1])) };
+			const __m128 xyz{ _mm_add_ps(xy, _mm_mul_ps(_mm_set1_ps(row.z), otherRows[2])) };
+			result.data[r] = Simd::Store(_mm_add_ps(xyz, _mm_mul_ps(_mm_set1_ps(row.w), otherRows[3])));
+		}
+
+		return result;
+	}
+#else
+	inline Vector3 Matrix::TransformVector(float x, float y, float z) const
+	{
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z,
+			data[0].y * x + data[1].y * y + data[2].y * z,
+			data[0].z * x + data[1].z * y + data[2].z * z
+		};
+	}
+
+	inline Vector3 Matrix::TransformPoint(float x, float y, float z) const
+	{
+		return Vector3{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+		};
+	}
+
+	inline Vector4 Matrix::TransformPoint(float x, float y, float z, [[maybe_unused]] float w) const
+	{
+		return Vector4{
+			data[0].x * x + data[1].x * y + data[2].x * z + data[3].x,
+			data[0].y * x + data[1].y * y + data[2].y * z + data[3].y,
+			data[0].z * x + data[1].z * y + data[2].z * z + data[3].z,
+			data[0].w * x + data[1].w * y + data[2].w * z + data[3].w
+		};
+	}
+
+	inline const Matrix& Matrix::Transpose()
+	{
+		Matrix result{};
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = data[c][r];
+			}
+		}
+
+		*this = result;
+		return *this;
+	}
+
+	inline Matrix Matrix::operator*(const Matrix& m) const
+	{
+		Matrix result{};
+		Matrix m_transposed = Transpose(m);
+
+		for (int r{ 0 }; r < 4; ++r)
+		{
+			for (int c{ 0 }; c < 4; ++c)
+			{
+				result[r][c] = Vector4::Dot(data[r], m_transposed[c]);
+			}
+		}
+
+		return result;
+	}
+#endif
+
+	inline const Matrix& Matrix::Inverse()
+	{
+		//Optimized Inverse as explained in FGED1 - used widely in other libraries too.
+		const Vector3 a = data[0];
+		const Vector3 b = data[1];
+		const Vector3 c = data[2];
+		const Vector3 d = data[3];
+
+		const float x = data[0][3];
+		const float y = data[1][3];
+		const float z = data[2][3];
+		const float w = data[3][3];
+
+		Vector3 s = Vector3::Cross(a, b);
+		Vector3 t = Vector3::Cross(c, d);
+		Vector3 u = a * y - b * x;
+		Vector3 v = c * w - d * z;
+
+		const float det = Vector3::Dot(s, v) + Vector3::Dot(t, u);
+		assert((!AreEqual(det, 0.f)) && "ERROR: determinant is 0, there is no INVERSE!");
+		const float invDet = 1.f / det;
+
+		s *= invDet; t *= invDet; u *= invDet; v *= invDet;
+
+		const Vector3 r0 = Vector3::Cross(b, v) + t * y;
+		const Vector3 r1 = Vector3::Cross(v, a) - t * x;
+		const Vector3 r2 = Vector3::Cross(d, u) + s * w;
+		//Vector3 r3 = Vector3::Cross(u, c) - s * z;
+
+		data[0] = Vector4{ r0.x, r1.x, r2.x, 0.f };
+		data[1] = Vector4{ r0.y, r1.y, r2.y, 0.f };
+		data[2] = Vector4{ r0.z, r1.z, r2.z, 0.f };
+		data[3] = {-Vector3::Dot(b, t),Vector3::Dot(a, t),-Vector3::Dot(d, s),Vector3::Dot(c, s) };
+
+		return *this;
+	}
+}
@@ -0,0 +1,162 @@
+#include "pch.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "VertexStage.h"
+#include <cstring>
+#include <filesystem>
+#include <type_traits>
+
+namespace dae
+{
+	namespace MeshCache
+	{
+		namespace
+		{
+			constexpr uint64_t BLOB_ALIGNMENT{ 16 };
+
+			static_assert(std::is_trivially_copyable_v<Vertex>, "Vertices are written and mapped as raw bytes");
+			static_assert(std::is_trivially_copyable_v<Header>, "The header is written and mapped as raw bytes");
+
+			uint64_t AlignUp(uint64_t value)
+			{
+				return (value + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+			}
+
+			bool GetSourceStamp(const std::string& sourcePath, uint64_t& size, int64_t& writeTime)
+			{
+				std::error_code error{};
+				size = std::filesystem::file_size(sourcePath, error);
+				if (error)
+					return false;
+
+				const std::filesystem::file_time_type time{ std::filesystem::last_write_time(sourcePath, error) };
+				if (error)
+					return false;
+
+				writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+				return true;
+			}
+		}
+
+		std::string GetCachePath(const std::string& sourcePath)
+		{
+			return sourcePath + ".meshcache";
+		}
+
+		std::unique_ptr<MappedFile> Open(const std::string& sourcePath, uint32_t parseFlags, MeshData& meshData)
+		{
+			uint64_t sourceSize{};
+			int64_t sourceWriteTime{};
+			if (!GetSourceStamp(sourcePath, sourceSize, sourceWriteTime))
+				return nullptr;
+
+			std::unique_ptr<MappedFile> pFile{ std::make_unique<MappedFile>(GetCachePath(sourcePath)) };
+			if (!pFile->IsValid() || pFile->GetSize() < sizeof(Header))
+				return nullptr;
+
+			Header header{};
+			std::memcpy(&header, pFile->GetData(), sizeof(Header));
+
+			const Header expected{};
+			if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != VERSION ||
+				header.vertexSize != sizeof(Vertex))
+				return nullptr;
+
+			if (header.parseFlags != parseFlags || header.optimizerVersion != MeshOptimizer::VERSION)
+				return nullptr;
+
+			if (header.sourceSize != sourceSize || header.sourceWriteTime != sourceWriteTime)
+				return nullptr;
+
+			//Never trust the offsets of a file on disk
+			const uint64_t fileSize{ pFile->GetSize() };
+			const bool isVertexBlobInside{ header.vertexOffset % BLOB_ALIGNMENT == 0 && header.vertexOffset <= fileSize &&
+				header.vertexCount <= (fileSize - header.vertexOffset) / sizeof(Vertex) };
+			const bool isStreamBlobInside{ header.streamOffset % BLOB_ALIGNMENT == 0 && header.streamOffset <= fileSize &&
+				VertexStreams::GetBlockSize(header.vertexCount) <= (fileSize - header.streamOffset) / sizeof(float) };
+			const bool isIndexBlobInside{ header.indexOffset % BLOB_ALIGNMENT == 0 && header.indexOffset <= fileSize &&
+				header.indexCount <= (fileSize - header.indexOffset) / sizeof(uint32_t) };
+			//Earlier builds also cached failed parses, those are parsed again
+			if (!isVertexBlobInside || !isStreamBlobInside || !isIndexBlobInside || header.indexCount == 0)
+				return nullptr;
+
+			meshData.pVertices = reinterpret_cast<const Vertex*>(pFile->GetData() + header.vertexOffset);
+			meshData.vertexCount = static_cast<size_t>(header.vertexCount);
+			meshData.pStreams = reinterpret_cast<const float*>(pFile->GetData() + header.streamOffset);
+			meshData.pIndices = reinterpret_cast<const uint32_t*>(pFile->GetData() + header.indexOffset);
+			meshData.indexCount = static_cast<size_t>(header.indexCount);
+			meshData.boundsMin = header.boundsMin;
+			meshData.boundsMax = header.boundsMax;
+
+			for (size_t i{}; i < meshData.indexCount; ++i)
+			{
+				if (meshData.pIndices[i] >= meshData.vertexCount)
+					return nullptr;
+			}
+
+			return pFile;
+		}
+
+		bool Write(const std::string& sourcePath, uint32_t parseFlags, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+		{
+			//An empty mesh is what a failed parse leaves, cached it would be mapped on every run until the source changes
+			if (indices.empty())
+				return false;
+
+			Header header{};
+			header.vertexSize = sizeof(Vertex);
+			header.parseFlags = parseFlags;
+			header.optimizerVersion = MeshOptimizer::VERSION;
+			if (!GetSourceStamp(sourcePath, header.sourceSize, header.sourceWriteTime))
+				return false;
+
+			header.vertexCount = vertices.size();
+			header.indexCount = indices.size();
+			header.vertexOffset = AlignUp(sizeof(Header));
+			header.streamOffset = AlignUp(header.vertexOffset + vertices.size() * sizeof(Vertex));
+			header.indexOffset = AlignUp(header.streamOffset + VertexStreams::GetBlockSize(vertices.size()) * sizeof(float));
+
+			std::vector<float> streams(VertexStreams::GetBlockSize(vertices.size()));
+			VertexStreams::FillBlock(vertices, streams);
+
+			if (!vertices.empty())
+			{
+				header.boundsMin = vertices.front().position;
+				header.boundsMax = vertices.front().position;
+				for (const Vertex& vertex : vertices)
+				{
+					header.boundsMin = Vector3::Min(header.boundsMin, vertex.position);
+					header.boundsMax = Vector3::Max(header.boundsMax, vertex.position);
+				}
+			}
+
+			const std::string cachePath{ GetCachePath(sourcePath) };
+			const std::string tempPath{ cachePath + ".tmp" };
+			{
+				std::ofstream file{ tempPath, std::ios::binary | std::ios::trunc };
+				if (!file)
+					return false;
+
+				const char zeros[BLOB_ALIGNMENT]{};
+				file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+				file.write(zeros, header.vertexOffset - sizeof(Header));
+				file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(Vertex));
+				file.write(zeros, header.streamOffset - (header.vertexOffset + vertices.size() * sizeof(Vertex)));
+				file.write(reinterpret_cast<const char*>(streams.data()), streams.size() * sizeof(float));
+				file.write(zeros, header.indexOffset - (header.streamOffset + streams.size() * sizeof(float)));
+				file.write(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+				if (!file)
+					return false;
+			}
+
+			std::error_code error{};
+			std::filesystem::rename(tempPath, cachePath, error);
+			if (error)
+			{
+				std::filesystem::remove(tempPath, error);
+				return false;
+			}
+			return true;
+		}
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "DataTypes.h"
+#include "MappedFile.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	//Binary copy of a parsed and optimised mesh next to its source file (<source>.meshcache),
+	//memory mapped on later runs so no text has to be parsed at startup
+	namespace MeshCache
+	{
+		//Bump whenever the file layout or the way meshes are built from OBJ files changes
+		constexpr uint32_t VERSION{ 3 };
+
+		//What the mesh was built with besides the source file, bit flags of the header
+		constexpr uint32_t PARSE_FLIP_AXIS_AND_WINDING{ 1 << 0 };
+
+		struct Header
+		{
+			char magic[4]{ 'D', 'A', 'E', 'M' };
+			uint32_t version{ VERSION };
+			//sizeof(Vertex) of the build that wrote the file, a changed vertex layout invalidates the cache
+			uint32_t vertexSize{};
+			//PARSE_ flags the OBJ was parsed with and MeshOptimizer::VERSION, a cache built differently is rebuilt
+			uint32_t parseFlags{};
+			uint32_t optimizerVersion{};
+			uint32_t padding{};
+
+			//Stale check against the source file, rebuilt when either changes
+			uint64_t sourceSize{};
+			int64_t sourceWriteTime{};
+
+			uint64_t vertexCount{};
+			uint64_t indexCount{};
+			//Byte offsets from the start of the file, every blob is 16 byte aligned.
+			//The stream blob holds the VertexStreams of the vertices, laid out by VertexStreams::FillBlock
+			uint64_t vertexOffset{};
+			uint64_t streamOffset{};
+			uint64_t indexOffset{};
+
+			Vector3 boundsMin{};
+			Vector3 boundsMax{};
+		};
+
+		//Points into the mapping, valid for as long as the MappedFile returned by Open lives
+		struct MeshData
+		{
+			const Vertex* pVertices{ nullptr };
+			size_t vertexCount{};
+			//VertexStreams::GetBlockSize(vertexCount) floats, for VertexStreams::Attach
+			const float* pStreams{ nullptr };
+			const uint32_t* pIndices{ nullptr };
+			size_t indexCount{};
+			Vector3 boundsMin{};
+			Vector3 boundsMax{};
+		};
+
+		std::string GetCachePath(const std::string& sourcePath);
+
+		//nullptr when there is no cache for sourcePath yet, or it is stale, from another version, built with other parseFlags, empty or damaged
+		std::unique_ptr<MappedFile> Open(const std::string& sourcePath, uint32_t parseFlags, MeshData& meshData);
+
+		//Writes to a temporary file first and renames it, so an interrupted write never leaves a half cache behind.
+		//Refuses meshes without indices, false when nothing was written
+		bool Write(const std::string& sourcePath, uint32_t parseFlags, const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+	}
+}
@@ -0,0 +1,244 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include <cmath>
+
+namespace dae
+{
+	namespace MeshOptimizer
+	{
+		namespace
+		{
+			//Forsyth's scoring: the cache the ordering optimises for is modelled as LRU,
+			//which also does well on the smaller FIFO caches actually found in hardware
+			constexpr int SCORING_CACHE_SIZE{ 32 };
+			constexpr int MAX_VALENCE_SCORED{ 32 };
+			constexpr float CACHE_DECAY_POWER{ 1.5f };
+			constexpr float LAST_TRIANGLE_SCORE{ 0.75f };
+			constexpr float VALENCE_BOOST_SCALE{ 2.f };
+			constexpr float VALENCE_BOOST_POWER{ 0.5f };
+
+			struct ScoreTables
+			{
+				float cache[SCORING_CACHE_SIZE]{};
+				float valence[MAX_VALENCE_SCORED + 1]{};
+
+				ScoreTables()
+				{
+					for (int position{}; position < SCORING_CACHE_SIZE; ++position)
+					{
+						//The three vertices of the last triangle score the same, whatever order they were added in
+						if (position < 3)
+							cache[position] = LAST_TRIANGLE_SCORE;
+						else
+							cache[position] = std::pow(1.f - static_cast<float>(position - 3) / (SCORING_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+					}
+
+					//Vertices with few triangles left are worth finishing, so they do not have to be loaded again later
+					for (int triangles{ 1 }; triangles <= MAX_VALENCE_SCORED; ++triangles)
+						valence[triangles] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(triangles), -VALENCE_BOOST_POWER);
+				}
+
+				float VertexScore(int cachePosition, uint32_t remainingTriangles) const
+				{
+					if (remainingTriangles == 0)
+						return -1.f;
+
+					const float cacheScore{ cachePosition < 0 ? 0.f : cache[cachePosition] };
+					return cacheScore + valence[std::min<uint32_t>(remainingTriangles, MAX_VALENCE_SCORED)];
+				}
+			};
+		}
+
+		VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize)
+		{
+			//FIFO: a vertex is still cached when fewer than cacheSize misses happened since it was loaded
+			std::vector<int64_t> loadedAt(vertexCount, -static_cast<int64_t>(cacheSize) - 1);
+			std::vector<bool> isUsed(vertexCount, false);
+
+			int64_t misses{};
+			size_t usedVertices{};
+			for (uint32_t index : indices)
+			{
+				if (misses - loadedAt[index] > cacheSize)
+				{
+					loadedAt[index] = misses;
+					++misses;
+				}
+
+				if (!isUsed[index])
+				{
+					isUsed[index] = true;
+					++usedVertices;
+				}
+			}
+
+			VertexCacheStats stats{};
+			if (indices.size() >= 3)
+				stats.acmr = static_cast<float>(misses) / (indices.size() / 3);
+			if (usedVertices > 0)
+				stats.atvr = static_cast<float>(misses) / usedVertices;
+			return stats;
+		}
+
+		void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+		{
+			static const ScoreTables scoreTables{};
+
+			const size_t triangleCount{ indices.size() / 3 };
+			if (triangleCount == 0)
+				return;
+
+			//Triangles around every vertex, each list keeps its live triangles in front
+			std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+			for (size_t i{}; i < triangleCount * 3; ++i)
+				++remainingTriangles[indices[i]];
+
+			std::vector<uint32_t> adjacencyStart(vertexCount + 1, 0);
+			for (size_t vertex{}; vertex < vertexCount; ++vertex)
+				adjacencyStart[vertex + 1] = adjacencyStart[vertex] + remainingTriangles[vertex];
+
+			std::vector<uint32_t> adjacency(adjacencyStart[vertexCount]);
+			{
+				std::vector<uint32_t> fillCount(vertexCount, 0);
+				for (size_t i{}; i < triangleCount * 3; ++i)
+				{
+					const uint32_t vertex{ indices[i] };
+					adjacency[adjacencyStart[vertex] + fillCount[vertex]++] = static_cast<uint32_t>(i / 3);
+				}
+			}
+
+			std::vector<int> cachePosition(vertexCount, -1);
+			std::vector<float> vertexScore(vertexCount);
+			for (size_t vertex{}; vertex < vertexCount; ++vertex)
+				vertexScore[vertex] = scoreTables.VertexScore(-1, remainingTriangles[vertex]);
+
+			std::vector<bool> isTriangleAdded(triangleCount, false);
+
+			//Dead ends continue at the first triangle in input order that is not added yet. Everything before the cursor
+			//is added, so it only moves forward and all dead ends together scan the triangles once
+			size_t inputCursor{};
+			auto findNextRemainingTriangle = [&]()
+			{
+				while (inputCursor < triangleCount && isTriangleAdded[inputCursor])
+					++inputCursor;
+				return inputCursor < triangleCount ? static_cast<int64_t>(inputCursor) : int64_t{ -1 };
+			};
+
+			std::vector<uint32_t> optimizedIndices;
+			optimizedIndices.reserve(triangleCount * 3);
+
+			//A triangle can push up to three new vertices in front, the ones falling off the end get their score updated once more
+			uint32_t cache[SCORING_CACHE_SIZE + 3];
+			uint32_t newCache[SCORING_CACHE_SIZE + 3];
+			int cacheSize{};
+
+			int64_t bestTriangle{ findNextRemainingTriangle() };
+			while (bestTriangle >= 0)
+			{
+				const uint32_t* pTriangle{ indices.data() + bestTriangle * 3 };
+				isTriangleAdded[bestTriangle] = true;
+
+				int newCacheSize{};
+				for (int corner{}; corner < 3; ++corner)
+				{
+					const uint32_t vertex{ pTriangle[corner] };
+					optimizedIndices.push_back(vertex);
+					newCache[newCacheSize++] = vertex;
+
+					//Swap the triangle out of the live part of the adjacency list
+					uint32_t* pAdjacency{ adjacency.data() + adjacencyStart[vertex] };
+					const uint32_t lastLive{ --remainingTriangles[vertex] };
+					for (uint32_t i{}; i <= lastLive; ++i)
+					{
+						if (pAdjacency[i] == bestTriangle)
+						{
+							std::swap(pAdjacency[i], pAdjacency[lastLive]);
+							break;
+						}
+					}
+				}
+
+				for (int i{}; i < cacheSize; ++i)
+				{
+					const uint32_t vertex{ cache[i] };
+					if (vertex != pTriangle[0] && vertex != pTriangle[1] && vertex != pTriangle[2])
+						newCache[newCacheSize++] = vertex;
+				}
+
+				//Rescore the vertices that moved or dropped out, then the live triangles around them
+				for (int i{}; i < newCacheSize; ++i)
+				{
+					const uint32_t vertex{ newCache[i] };
+					cachePosition[vertex] = i < SCORING_CACHE_SIZE ? i : -1;
+					vertexScore[vertex] = scoreTables.VertexScore(cachePosition[vertex], remainingTriangles[vertex]);
+				}
+
+				bestTriangle = -1;
+				float bestScore{ -1.f };
+				for (int i{}; i < newCacheSize; ++i)
+				{
+					const uint32_t vertex{ newCache[i] };
+					const uint32_t* pAdjacency{ adjacency.data() + adjacencyStart[vertex] };
+					for (uint32_t j{}; j < remainingTriangles[vertex]; ++j)
+					{
+						const uint32_t triangle{ pAdjacency[j] };
+						const float score{ vertexScore[indices[triangle * 3]] + vertexScore[indices[triangle * 3 + 1]] + vertexScore[indices[triangle * 3 + 2]] };
+
+						if (score > bestScore)
+						{
+							bestScore = score;
+							bestTriangle = triangle;
+						}
+					}
+				}
+
+				cacheSize = std::min(newCacheSize, SCORING_CACHE_SIZE);
+				std::copy_n(newCache, cacheSize, cache);
+
+				//Nothing left around the cached vertices: continue in another part of the mesh
+				if (bestTriangle < 0)
+					bestTriangle = findNextRemainingTriangle();
+			}
+
+			std::copy(optimizedIndices.begin(), optimizedIndices.end(), indices.begin());
+		}
+
+		void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			constexpr uint32_t unassigned{ UINT32_MAX };
+			std::vector<uint32_t> remap(vertices.size(), unassigned);
+
+			uint32_t nextVertex{};
+			for (uint32_t& index : indices)
+			{
+				if (remap[index] == unassigned)
+					remap[index] = nextVertex++;
+				index = remap[index];
+			}
+
+			for (uint32_t& newIndex : remap)
+			{
+				if (newIndex == unassigned)
+					newIndex = nextVertex++;
+			}
+
+			std::vector<Vertex> optimizedVertices(vertices.size());
+			for (size_t vertex{}; vertex < vertices.size(); ++vertex)
+				optimizedVertices[remap[vertex]] = vertices[vertex];
+			vertices.swap(optimizedVertices);
+		}
+
+		void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+		{
+			const VertexCacheStats before{ AnalyzeVertexCache(indices, vertices.size()) };
+
+			OptimizeVertexCache(indices, vertices.size());
+			OptimizeVertexFetch(vertices, indices);
+
+			const VertexCacheStats after{ AnalyzeVertexCache(indices, vertices.size()) };
+
+			std::cout << "Vertex cache (FIFO " << SIMULATED_CACHE_SIZE << "), " << indices.size() / 3 << " triangles: ACMR "
+				<< before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << "\n";
+		}
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "DataTypes.h"
+
+namespace dae
+{
+	//Load time reordering of indexed triangle lists, the triangles themselves are never changed
+	namespace MeshOptimizer
+	{
+		//Post-transform cache the ACMR/ATVR figures are measured with, the usual FIFO size of GPUs
+		constexpr int SIMULATED_CACHE_SIZE{ 16 };
+
+		//Bump whenever OptimizeMesh orders the triangles or vertices differently, mesh caches built by another version are rebuilt
+		constexpr uint32_t VERSION{ 2 };
+
+		struct VertexCacheStats
+		{
+			//Average cache miss ratio: transformed vertices per triangle, 0.5 is the limit for regular grids
+			float acmr{};
+			//Average transform to vertex ratio: transformed vertices per unique vertex, 1 is the optimum
+			float atvr{};
+		};
+
+		VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount, int cacheSize = SIMULATED_CACHE_SIZE);
+
+		//Forsyth's linear speed vertex cache optimisation, reorders the triangles of the list
+		void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+		//Renumbers the vertices in the order the indices first use them, unused vertices go to the back
+		void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+		//Both passes above, prints the ACMR/ATVR before and after
+		void OptimizeMesh(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+	}
+}
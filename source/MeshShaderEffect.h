@@ -33,9 +33,9 @@ namespace dae
 				std::wcout << L"m_pInvViewMatrixVariable not valid \n";
 		}
 
-		void SetNormalMap(Texture* pNormalTexture) { if (m_pNormalMapVariable) m_pNormalMapVariable->SetResource(pNormalTexture->GetSRV()); }
-		void SetSpecularMap(Texture* pSpecularTexture) { if (m_pSpecularMapVariable) m_pSpecularMapVariable->SetResource(pSpecularTexture->GetSRV()); }
-		void SetGlossinessMap(Texture* pGlossinessTexture) { if (m_pGlossinessMapVariable) m_pGlossinessMapVariable->SetResource(pGlossinessTexture->GetSRV()); }
+		void SetNormalMap(const HardwareTexture* pNormalTexture) { if (m_pNormalMapVariable) m_pNormalMapVariable->SetResource(pNormalTexture->GetSRV()); }
+		void SetSpecularMap(const HardwareTexture* pSpecularTexture) { if (m_pSpecularMapVariable) m_pSpecularMapVariable->SetResource(pSpecularTexture->GetSRV()); }
+		void SetGlossinessMap(const HardwareTexture* pGlossinessTexture) { if (m_pGlossinessMapVariable) m_pGlossinessMapVariable->SetResource(pGlossinessTexture->GetSRV()); }
 	private:
 		ID3DX11EffectShaderResourceVariable* m_pNormalMapVariable;
 		ID3DX11EffectShaderResourceVariable* m_pSpecularMapVariable;
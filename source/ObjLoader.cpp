@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "ObjLoader.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "Utils.h"
+#include <charconv>
+#include <cstring>
+
+namespace dae
+{
+	namespace ObjLoader
+	{
+		namespace
+		{
+			//Small files are not worth the threads, big ones get a few chunks per thread to even out the work
+			constexpr size_t MIN_CHUNK_SIZE{ 256 * 1024 };
+			constexpr uint32_t CHUNKS_PER_THREAD{ 4 };
+
+			struct ObjChunk
+			{
+				std::vector<Vector3> positions{};
+				std::vector<Vector2> UVs{};
+				std::vector<Vector3> normals{};
+				std::vector<Utils::ObjCornerKey> corners{};
+				bool isValid{ true };
+			};
+
+			const char* SkipSpaces(const char* pText, const char* pEnd)
+			{
+				while (pText < pEnd && (*pText == ' ' || *pText == '\t' || *pText == '\r'))
+					++pText;
+				return pText;
+			}
+
+			bool ParseFloat(const char*& pText, const char* pEnd, float& value)
+			{
+				pText = SkipSpaces(pText, pEnd);
+				if (pText < pEnd && *pText == '+')
+					++pText;
+
+				const std::from_chars_result result{ std::from_chars(pText, pEnd, value) };
+				if (result.ec != std::errc{})
+					return false;
+
+				pText = result.ptr;
+				return true;
+			}
+
+			bool ParseIndex(const char*& pText, const char* pEnd, size_t& value)
+			{
+				const std::from_chars_result result{ std::from_chars(pText, pEnd, value) };
+				if (result.ec != std::errc{})
+					return false;
+
+				pText = result.ptr;
+				return true;
+			}
+
+			//v/vt/vn and f lines, everything else (comments, groups, materials) is skipped
+			bool ParseLine(const char* pText, const char* pEnd, ObjChunk& chunk)
+			{
+				pText = SkipSpaces(pText, pEnd);
+
+				const char* pCommandEnd{ pText };
+				while (pCommandEnd < pEnd && *pCommandEnd != ' ' && *pCommandEnd != '\t')
+					++pCommandEnd;
+				const size_t commandLength{ static_cast<size_t>(pCommandEnd - pText) };
+
+				if (commandLength == 1 && pText[0] == 'v')
+				{
+					Vector3 position{};
+					pText = pCommandEnd;
+					if (!ParseFloat(pText, pEnd, position.x) || !ParseFloat(pText, pEnd, position.y) || !ParseFloat(pText, pEnd, position.z))
+						return false;
+					chunk.positions.push_back(position);
+				}
+				else if (commandLength == 2 && pText[0] == 'v' && pText[1] == 't')
+				{
+					float u{}, v{};
+					pText = pCommandEnd;
+					if (!ParseFloat(pText, pEnd, u) || !ParseFloat(pText, pEnd, v))
+						return false;
+					chunk.UVs.emplace_back(u, 1 - v);
+				}
+				else if (commandLength == 2 && pText[0] == 'v' && pText[1] == 'n')
+				{
+					Vector3 normal{};
+					pText = pCommandEnd;
+					if (!ParseFloat(pText, pEnd, normal.x) || !ParseFloat(pText, pEnd, normal.y) || !ParseFloat(pText, pEnd, normal.z))
+						return false;
+					chunk.normals.push_back(normal);
+				}
+				else if (commandLength == 1 && pText[0] == 'f')
+				{
+					Utils::ObjCornerKey firstCorner{};
+					Utils::ObjCornerKey previousCorner{};
+					int cornerCount{};
+
+					pText = pCommandEnd;
+					for (pText = SkipSpaces(pText, pEnd); pText < pEnd; pText = SkipSpaces(pText, pEnd))
+					{
+						//position, position/uv, position//normal or position/uv/normal
+						Utils::ObjCornerKey corner{};
+						if (!ParseIndex(pText, pEnd, corner.iPosition))
+							return false;
+
+						if (pText < pEnd && *pText == '/')
+						{
+							++pText;
+							if (pText < pEnd && *pText != '/' && !ParseIndex(pText, pEnd, corner.iTexCoord))
+								return false;
+
+							if (pText < pEnd && *pText == '/')
+							{
+								++pText;
+								if (!ParseIndex(pText, pEnd, corner.iNormal))
+									return false;
+							}
+						}
+
+						if (cornerCount == 0)
+						{
+							firstCorner = corner;
+						}
+						else if (cornerCount >= 2)
+						{
+							chunk.corners.push_back(firstCorner);
+							chunk.corners.push_back(previousCorner);
+							chunk.corners.push_back(corner);
+						}
+						previousCorner = corner;
+						++cornerCount;
+					}
+
+					if (cornerCount < 3)
+						return false;
+				}
+				return true;
+			}
+
+			void ParseChunk(const char* pBegin, const char* pEnd, ObjChunk& chunk)
+			{
+				for (const char* pLine{ pBegin }; pLine < pEnd && chunk.isValid;)
+				{
+					const char* pLineEnd{ static_cast<const char*>(std::memchr(pLine, '\n', pEnd - pLine)) };
+					if (!pLineEnd)
+						pLineEnd = pEnd;
+
+					chunk.isValid = ParseLine(pLine, pLineEnd, chunk);
+					pLine = pLineEnd + 1;
+				}
+			}
+
+			template<typename T>
+			void AppendPool(std::vector<T>& destination, const std::vector<ObjChunk>& chunks, std::vector<T> ObjChunk::* pPool)
+			{
+				size_t totalSize{};
+				for (const ObjChunk& chunk : chunks)
+					totalSize += (chunk.*pPool).size();
+
+				destination.reserve(totalSize);
+				for (const ObjChunk& chunk : chunks)
+					destination.insert(destination.end(), (chunk.*pPool).begin(), (chunk.*pPool).end());
+			}
+		}
+
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+			ThreadPool& threadPool, bool flipAxisAndWinding, bool printStats)
+		{
+			const MappedFile file{ filename };
+			if (!file.IsValid())
+				return false;
+
+			const char* pData{ file.GetData() };
+			const size_t size{ file.GetSize() };
+
+			const size_t maxChunks{ static_cast<size_t>(threadPool.GetNumThreads()) * CHUNKS_PER_THREAD };
+			const size_t chunkCount{ std::clamp<size_t>(size / MIN_CHUNK_SIZE, 1, maxChunks) };
+
+			//Chunk i starts after the first line break at or past i * size / chunkCount, so no line is split
+			std::vector<size_t> chunkStarts(chunkCount + 1, size);
+			chunkStarts[0] = 0;
+			for (size_t i{ 1 }; i < chunkCount; ++i)
+			{
+				const size_t target{ std::max(size * i / chunkCount, chunkStarts[i - 1]) };
+				const char* pLineEnd{ static_cast<const char*>(std::memchr(pData + target, '\n', size - target)) };
+				chunkStarts[i] = pLineEnd ? static_cast<size_t>(pLineEnd - pData) + 1 : size;
+			}
+
+			std::vector<ObjChunk> chunks(chunkCount);
+			threadPool.ParallelFor(static_cast<uint32_t>(chunkCount), [&](uint32_t chunkIdx)
+				{
+					ParseChunk(pData + chunkStarts[chunkIdx], pData + chunkStarts[chunkIdx + 1], chunks[chunkIdx]);
+				});
+
+			for (const ObjChunk& chunk : chunks)
+			{
+				if (!chunk.isValid)
+					return false;
+			}
+
+			//OBJ indices are global, so concatenating the pools in file order keeps every index valid
+			std::vector<Vector3> positions{};
+			std::vector<Vector2> UVs{};
+			std::vector<Vector3> normals{};
+			std::vector<Utils::ObjCornerKey> corners{};
+			AppendPool(positions, chunks, &ObjChunk::positions);
+			AppendPool(UVs, chunks, &ObjChunk::UVs);
+			AppendPool(normals, chunks, &ObjChunk::normals);
+			AppendPool(corners, chunks, &ObjChunk::corners);
+			chunks.clear();
+
+			return Utils::BuildIndexedMesh(filename, positions, UVs, normals, corners, vertices, indices, flipAxisAndWinding, printStats);
+		}
+	}
+}
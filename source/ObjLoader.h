@@ -0,0 +1,19 @@
+#pragma once
+#include "DataTypes.h"
+#include <string>
+#include <vector>
+
+namespace dae
+{
+	class ThreadPool;
+
+	//OBJ loading for big files: the file is memory mapped, split into line aligned chunks
+	//and the chunks are parsed with std::from_chars on all threads of the pool
+	namespace ObjLoader
+	{
+		//Same output as Utils::ParseOBJ, faces with more than three corners are fanned into triangles.
+		//False when the file cannot be mapped or contains a malformed or out of range line
+		bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+			ThreadPool& threadPool, bool flipAxisAndWinding = true, bool printStats = true);
+	}
+}
@@ -0,0 +1,60 @@
+#include "pch.h"
+#include "PixelPacking.h"
+#include "SimdTarget.h"
+
+namespace dae
+{
+	namespace PixelPacking
+	{
+		namespace
+		{
+			void PackScalar(const float* pRed, const float* pGreen, const float* pBlue, int count, uint32_t* pPacked)
+			{
+				for (int x{}; x < count; ++x)
+					pPacked[x] = PackColor(pRed[x], pGreen[x], pBlue[x]);
+			}
+
+#if DAE_SIMD_X86
+			//Same operations as PackColor: max, divide where the max is above one, multiply, truncate
+			DAE_TARGET_AVX2 void PackAVX2(const float* pRed, const float* pGreen, const float* pBlue, int count, uint32_t* pPacked)
+			{
+				constexpr int laneCount{ 8 };
+				const __m256 one{ _mm256_set1_ps(1.f) };
+				const __m256 scale{ _mm256_set1_ps(255.f) };
+				const __m256i alpha{ _mm256_set1_epi32(static_cast<int>(OPAQUE_ALPHA)) };
+
+				int x{};
+				for (; x + laneCount <= count; x += laneCount)
+				{
+					__m256 red{ _mm256_loadu_ps(pRed + x) };
+					__m256 green{ _mm256_loadu_ps(pGreen + x) };
+					__m256 blue{ _mm256_loadu_ps(pBlue + x) };
+
+					const __m256 maxValue{ _mm256_max_ps(red, _mm256_max_ps(green, blue)) };
+					const __m256 isTooBright{ _mm256_cmp_ps(maxValue, one, _CMP_GT_OQ) };
+					red = _mm256_blendv_ps(red, _mm256_div_ps(red, maxValue), isTooBright);
+					green = _mm256_blendv_ps(green, _mm256_div_ps(green, maxValue), isTooBright);
+					blue = _mm256_blendv_ps(blue, _mm256_div_ps(blue, maxValue), isTooBright);
+
+					const __m256i packedRed{ _mm256_cvttps_epi32(_mm256_mul_ps(red, scale)) };
+					const __m256i packedGreen{ _mm256_slli_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(green, scale)), 8) };
+					const __m256i packedBlue{ _mm256_slli_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(blue, scale)), 16) };
+					const __m256i packed{ _mm256_or_si256(_mm256_or_si256(packedRed, packedGreen), _mm256_or_si256(packedBlue, alpha)) };
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(pPacked + x), packed);
+				}
+
+				PackScalar(pRed + x, pGreen + x, pBlue + x, count - x, pPacked + x);
+			}
+#endif
+		}
+
+		PackFunction GetPackFunction(RasterKernels::KernelType type)
+		{
+#if DAE_SIMD_X86
+			if (type == RasterKernels::KernelType::AVX2)
+				return PackAVX2;
+#endif
+			return PackScalar;
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "RasterKernels.h"
+
+//Standard includes
+#include <algorithm>
+#include <cstdint>
+
+namespace dae
+{
+	namespace PixelPacking
+	{
+		//Byte order of the packed software framebuffer: R, G, B, A in memory, SDL_PIXELFORMAT_RGBA32
+		constexpr uint32_t OPAQUE_ALPHA{ 0xFF000000u };
+
+		//Same conversion as ColorRGB::MaxToOne followed by static_cast<uint8_t>(channel * 255).
+		//Shading never produces negative channels, so every channel ends up in [0, 255]
+		inline uint32_t PackColor(float r, float g, float b)
+		{
+			const float maxValue{ std::max(r, std::max(g, b)) };
+			if (maxValue > 1.f)
+			{
+				r /= maxValue;
+				g /= maxValue;
+				b /= maxValue;
+			}
+			return static_cast<uint32_t>(r * 255) | (static_cast<uint32_t>(g * 255) << 8) | (static_cast<uint32_t>(b * 255) << 16) | OPAQUE_ALPHA;
+		}
+
+		//Packs count pixels of three float color planes into RGBA8, every pixel exactly as PackColor does
+		using PackFunction = void(*)(const float* pRed, const float* pGreen, const float* pBlue, int count, uint32_t* pPacked);
+
+		//The AVX2 version (8 pixels per iteration) for KernelType::AVX2, the scalar one otherwise
+		PackFunction GetPackFunction(RasterKernels::KernelType type);
+	}
+}
@@ -0,0 +1,248 @@
+#include "pch.h"
+#include "RasterKernels.h"
+#include "SimdTarget.h"
+
+namespace dae
+{
+	namespace RasterKernels
+	{
+#if DAE_SIMD_X86
+		namespace
+		{
+			void CpuId(int info[4], int leaf, int subLeaf)
+			{
+#if defined(_MSC_VER) && !defined(__clang__)
+				__cpuidex(info, leaf, subLeaf);
+#else
+				unsigned int a{}, b{}, c{}, d{};
+				__cpuid_count(leaf, subLeaf, a, b, c, d);
+				info[0] = static_cast<int>(a);
+				info[1] = static_cast<int>(b);
+				info[2] = static_cast<int>(c);
+				info[3] = static_cast<int>(d);
+#endif
+			}
+
+			uint64_t ReadXCR0()
+			{
+#if defined(_MSC_VER) && !defined(__clang__)
+				return _xgetbv(0);
+#else
+				unsigned int eax{}, edx{};
+				__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+				return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+			}
+
+			DAE_TARGET_SSE41 uint64_t SpanKernelSSE41(const SpanSetup& setup, int count, float* pDepthRow, SpanFragments& fragments)
+			{
+				constexpr int laneCount{ 4 };
+				const __m128 laneOffsets{ _mm_setr_ps(0.f, 1.f, 2.f, 3.f) };
+				const __m128 invArea{ _mm_set1_ps(setup.invTriangleArea) };
+
+				__m128 edges[3];
+				__m128 chunkSteps[3];
+				__m128 thresholds[3];
+				__m128 invDepthZ[3];
+				__m128 invDepthW[3];
+				for (int i = 0; i < 3; ++i)
+				{
+					edges[i] = _mm_add_ps(_mm_set1_ps(setup.edge[i]), _mm_mul_ps(laneOffsets, _mm_set1_ps(setup.edgeStep[i])));
+					chunkSteps[i] = _mm_set1_ps(setup.edgeStep[i] * laneCount);
+					thresholds[i] = _mm_set1_ps(setup.edgeThreshold[i]);
+					invDepthZ[i] = _mm_set1_ps(setup.invDepthZ[i]);
+					invDepthW[i] = _mm_set1_ps(setup.invDepthW[i]);
+				}
+
+				uint64_t spanMask{};
+				for (int x = 0; x < count; x += laneCount)
+				{
+					const __m128 inside{ _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(edges[0], thresholds[0]), _mm_cmpgt_ps(edges[1], thresholds[1])), _mm_cmpgt_ps(edges[2], thresholds[2])) };
+					const __m128 inSpan{ _mm_cmplt_ps(laneOffsets, _mm_set1_ps(static_cast<float>(count - x))) };
+					__m128 covered{ setup.isFullyCovered ? inSpan : _mm_and_ps(inside, inSpan) };
+
+					if (_mm_movemask_ps(covered) != 0)
+					{
+						const __m128 weight0{ _mm_mul_ps(edges[0], invArea) };
+						const __m128 weight1{ _mm_mul_ps(edges[1], invArea) };
+						const __m128 weight2{ _mm_mul_ps(edges[2], invArea) };
+
+						const __m128 depthZ{ _mm_div_ps(_mm_set1_ps(1.f),
+							_mm_add_ps(_mm_add_ps(_mm_mul_ps(weight0, invDepthZ[0]), _mm_mul_ps(weight1, invDepthZ[1])), _mm_mul_ps(weight2, invDepthZ[2]))) };
+
+						//The last chunk of the span may stop inside the vector, never touch memory past count
+						const bool isFullChunk{ count - x >= laneCount };
+						alignas(16) float tailDepth[laneCount]{};
+						float* pDepth{ pDepthRow + x };
+						if (!isFullChunk)
+						{
+							for (int lane = 0; lane < count - x; ++lane)
+								tailDepth[lane] = pDepth[lane];
+						}
+
+						const __m128 storedDepth{ isFullChunk ? _mm_loadu_ps(pDepth) : _mm_load_ps(tailDepth) };
+						covered = _mm_and_ps(covered, _mm_cmple_ps(depthZ, storedDepth));
+
+						const int coveredBits{ _mm_movemask_ps(covered) };
+						if (coveredBits != 0)
+						{
+							const __m128 newDepth{ _mm_blendv_ps(storedDepth, depthZ, covered) };
+							if (isFullChunk)
+							{
+								_mm_storeu_ps(pDepth, newDepth);
+							}
+							else
+							{
+								_mm_store_ps(tailDepth, newDepth);
+								for (int lane = 0; lane < count - x; ++lane)
+									pDepth[lane] = tailDepth[lane];
+							}
+
+							const __m128 depthW{ _mm_div_ps(_mm_set1_ps(1.f),
+								_mm_add_ps(_mm_add_ps(_mm_mul_ps(weight0, invDepthW[0]), _mm_mul_ps(weight1, invDepthW[1])), _mm_mul_ps(weight2, invDepthW[2]))) };
+
+							_mm_store_ps(fragments.weight0 + x, weight0);
+							_mm_store_ps(fragments.weight1 + x, weight1);
+							_mm_store_ps(fragments.weight2 + x, weight2);
+							_mm_store_ps(fragments.depthZ + x, depthZ);
+							_mm_store_ps(fragments.depthW + x, depthW);
+
+							spanMask |= static_cast<uint64_t>(coveredBits) << x;
+						}
+					}
+
+					for (int i = 0; i < 3; ++i)
+						edges[i] = _mm_add_ps(edges[i], chunkSteps[i]);
+				}
+				return spanMask;
+			}
+
+			DAE_TARGET_AVX2 uint64_t SpanKernelAVX2(const SpanSetup& setup, int count, float* pDepthRow, SpanFragments& fragments)
+			{
+				constexpr int laneCount{ 8 };
+				const __m256 laneOffsets{ _mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f) };
+				const __m256 invArea{ _mm256_set1_ps(setup.invTriangleArea) };
+
+				__m256 edges[3];
+				__m256 chunkSteps[3];
+				__m256 thresholds[3];
+				__m256 invDepthZ[3];
+				__m256 invDepthW[3];
+				for (int i = 0; i < 3; ++i)
+				{
+					edges[i] = _mm256_add_ps(_mm256_set1_ps(setup.edge[i]), _mm256_mul_ps(laneOffsets, _mm256_set1_ps(setup.edgeStep[i])));
+					chunkSteps[i] = _mm256_set1_ps(setup.edgeStep[i] * laneCount);
+					thresholds[i] = _mm256_set1_ps(setup.edgeThreshold[i]);
+					invDepthZ[i] = _mm256_set1_ps(setup.invDepthZ[i]);
+					invDepthW[i] = _mm256_set1_ps(setup.invDepthW[i]);
+				}
+
+				uint64_t spanMask{};
+				for (int x = 0; x < count; x += laneCount)
+				{
+					const __m256 inside{ _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(edges[0], thresholds[0], _CMP_GT_OQ), _mm256_cmp_ps(edges[1], thresholds[1], _CMP_GT_OQ)), _mm256_cmp_ps(edges[2], thresholds[2], _CMP_GT_OQ)) };
+					const __m256 inSpan{ _mm256_cmp_ps(laneOffsets, _mm256_set1_ps(static_cast<float>(count - x)), _CMP_LT_OQ) };
+					__m256 covered{ setup.isFullyCovered ? inSpan : _mm256_and_ps(inside, inSpan) };
+
+					if (_mm256_movemask_ps(covered) != 0)
+					{
+						const __m256 weight0{ _mm256_mul_ps(edges[0], invArea) };
+						const __m256 weight1{ _mm256_mul_ps(edges[1], invArea) };
+						const __m256 weight2{ _mm256_mul_ps(edges[2], invArea) };
+
+						const __m256 depthZ{ _mm256_div_ps(_mm256_set1_ps(1.f),
+							_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(weight0, invDepthZ[0]), _mm256_mul_ps(weight1, invDepthZ[1])), _mm256_mul_ps(weight2, invDepthZ[2]))) };
+
+						//Masked load/store so the last chunk never touches memory past count
+						float* pDepth{ pDepthRow + x };
+						const __m256i inSpanBits{ _mm256_castps_si256(inSpan) };
+						const __m256 storedDepth{ _mm256_maskload_ps(pDepth, inSpanBits) };
+						covered = _mm256_and_ps(covered, _mm256_cmp_ps(depthZ, storedDepth, _CMP_LE_OQ));
+
+						const int coveredBits{ _mm256_movemask_ps(covered) };
+						if (coveredBits != 0)
+						{
+							_mm256_maskstore_ps(pDepth, _mm256_castps_si256(covered), depthZ);
+
+							const __m256 depthW{ _mm256_div_ps(_mm256_set1_ps(1.f),
+								_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(weight0, invDepthW[0]), _mm256_mul_ps(weight1, invDepthW[1])), _mm256_mul_ps(weight2, invDepthW[2]))) };
+
+							_mm256_store_ps(fragments.weight0 + x, weight0);
+							_mm256_store_ps(fragments.weight1 + x, weight1);
+							_mm256_store_ps(fragments.weight2 + x, weight2);
+							_mm256_store_ps(fragments.depthZ + x, depthZ);
+							_mm256_store_ps(fragments.depthW + x, depthW);
+
+							spanMask |= static_cast<uint64_t>(coveredBits) << x;
+						}
+					}
+
+					for (int i = 0; i < 3; ++i)
+						edges[i] = _mm256_add_ps(edges[i], chunkSteps[i]);
+				}
+				return spanMask;
+			}
+		}
+#endif
+
+		KernelType DetectKernelType()
+		{
+#if DAE_SIMD_X86
+			int info[4]{};
+			CpuId(info, 0, 0);
+			const int maxLeaf{ info[0] };
+
+			CpuId(info, 1, 0);
+			const bool hasSSE41{ (info[2] & (1 << 19)) != 0 };
+			const bool hasOSXSave{ (info[2] & (1 << 27)) != 0 };
+			const bool hasAVX{ (info[2] & (1 << 28)) != 0 };
+
+			bool hasAVX2{ false };
+			if (maxLeaf >= 7)
+			{
+				CpuId(info, 7, 0);
+				hasAVX2 = (info[1] & (1 << 5)) != 0;
+			}
+
+			//The OS has to save the YMM registers on context switches as well
+			const bool isYmmEnabled{ hasOSXSave && hasAVX && (ReadXCR0() & 0x6) == 0x6 };
+
+			if (hasAVX2 && isYmmEnabled)
+				return KernelType::AVX2;
+			if (hasSSE41)
+				return KernelType::SSE41;
+#endif
+			return KernelType::Scalar;
+		}
+
+		SpanKernel GetSpanKernel(KernelType type)
+		{
+#if DAE_SIMD_X86
+			switch (type)
+			{
+			case KernelType::SSE41:
+				return SpanKernelSSE41;
+			case KernelType::AVX2:
+				return SpanKernelAVX2;
+			default:
+				break;
+			}
+#endif
+			(void)type;
+			return nullptr;
+		}
+
+		const char* GetKernelName(KernelType type)
+		{
+			switch (type)
+			{
+			case KernelType::SSE41:
+				return "SSE4.1 (4-wide)";
+			case KernelType::AVX2:
+				return "AVX2 (8-wide)";
+			default:
+				return "Scalar";
+			}
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+//Standard includes
+#include <cstdint>
+
+namespace dae
+{
+	//Longest run of horizontally adjacent pixels handled by one span kernel call
+	constexpr int MAX_SPAN_SIZE{ 64 };
+
+	struct SpanSetup
+	{
+		//Edge function opposite vertex i at the first pixel of the span, and its step per pixel
+		float edge[3]{};
+		float edgeStep[3]{};
+		//Top-left rule: covered when every edge is above its threshold
+		float edgeThreshold[3]{};
+		float invTriangleArea{};
+
+		//Reciprocal vertex depths, the interpolated depth is 1 / sum(weight_i * invDepth_i)
+		float invDepthZ[3]{};
+		float invDepthW[3]{};
+
+		//Set for spans of a block that lies inside all three edges, only the depth test is left
+		bool isFullyCovered{ false };
+	};
+
+	struct SpanFragments
+	{
+		//Indexed by pixel offset in the span, only valid where the returned mask bit is set
+		alignas(32) float weight0[MAX_SPAN_SIZE];
+		alignas(32) float weight1[MAX_SPAN_SIZE];
+		alignas(32) float weight2[MAX_SPAN_SIZE];
+		alignas(32) float depthZ[MAX_SPAN_SIZE];
+		alignas(32) float depthW[MAX_SPAN_SIZE];
+	};
+
+	namespace RasterKernels
+	{
+		enum class KernelType
+		{
+			Scalar,
+			SSE41,
+			AVX2,
+
+			END
+		};
+
+		//Tests coverage and depth for count (<= MAX_SPAN_SIZE) pixels starting at pDepthRow,
+		//writes the depth of every passing pixel and returns them as a bit mask (bit i = pixel i)
+		using SpanKernel = uint64_t(*)(const SpanSetup& setup, int count, float* pDepthRow, SpanFragments& fragments);
+
+		//Best kernel the CPU and OS support, checked with CPUID
+		KernelType DetectKernelType();
+
+		//nullptr for Scalar: the caller keeps its own per pixel loop as the fallback
+		SpanKernel GetSpanKernel(KernelType type);
+		const char* GetKernelName(KernelType type);
+	}
+}
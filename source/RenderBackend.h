@@ -0,0 +1,83 @@
+#pragma once
+#include "Math.h"
+
+namespace dae
+{
+	class Mesh;
+	class Texture;
+
+	enum class RenderMode
+	{
+		Texture,
+		DepthBuffer,
+
+		END
+	};
+
+	enum class ColorMode
+	{
+		observedArea,
+		Diffuse,
+		Specular,
+		Combined,
+
+		END
+	};
+
+	enum class CullFaceMode
+	{
+		Front,
+		Back,
+		None,
+
+		END
+	};
+
+	//Textures a mesh is shaded with, the maps a material does not use stay nullptr.
+	//Backends leave out the shading terms of missing maps, without a normal map the vertex normals are used
+	struct Material
+	{
+		const Texture* pDiffuse{ nullptr };
+		const Texture* pNormal{ nullptr };
+		const Texture* pGlossiness{ nullptr };
+		const Texture* pSpecular{ nullptr };
+	};
+
+	//pMesh is nullptr while the mesh is still loading, backends skip it then
+	struct SceneObject
+	{
+		const Mesh* pMesh{ nullptr };
+		Material material{};
+	};
+
+	//Everything a backend needs to draw one frame, filled in by the renderer every frame.
+	//Backends only read the scene, the meshes and textures stay owned by the renderer
+	struct Scene
+	{
+		Matrix viewMatrix{};
+		Matrix projectionMatrix{};
+		Matrix invViewMatrix{};
+
+		SceneObject opaque{};
+		//Drawn with the world matrix of the opaque object, after it. The software backend has no blending and skips it
+		SceneObject transparent{};
+
+		CullFaceMode cullMode{ CullFaceMode::None };
+		bool isClearColorToggled{ false };
+	};
+
+	//One way of turning a Scene into pixels: the software rasterizer, or Direct3D 11 in the application
+	class RenderBackend
+	{
+	public:
+		RenderBackend() = default;
+		virtual ~RenderBackend() = default;
+
+		RenderBackend(const RenderBackend&) = delete;
+		RenderBackend(RenderBackend&&) noexcept = delete;
+		RenderBackend& operator=(const RenderBackend&) = delete;
+		RenderBackend& operator=(RenderBackend&&) noexcept = delete;
+
+		virtual void Render(const Scene& scene) = 0;
+	};
+}
@@ -1,14 +1,21 @@
 #pragma once
 #include "Math.h"
+#include "AssetLoader.h"
 #include "Mesh.h"
 #include "Camera.h"
 #include "Utils.h"
 #include "MeshShaderEffect.h"
 #include "TransparancyEffect.h"
 #include "DataTypes.h"
+#include "RenderBackend.h"
+#include "SoftwareBackend.h"
+#include "HardwareBackend.h"
+#include "FramePresenter.h"
+#include <chrono>
+#include <future>
+#include <string>
 
 struct SDL_Window;
-struct SDL_Surface;
 
 namespace dae
 {
@@ -21,33 +28,6 @@ namespace dae
 		END
 	};
 
-	enum class RenderMode
-	{
-		Texture,
-		DepthBuffer,
-
-		END
-	};
-
-	enum class ColorMode
-	{
-		observedArea,
-		Diffuse,
-		Specular,
-		Combined,
-
-		END
-	};
-
-	enum class CullFaceMode
-	{
-		Front,
-		Back,
-		None,
-
-		END
-	};
-
 	
 	class Renderer final
 	{
@@ -56,6 +36,9 @@ namespace dae
 	public:
 
 		Renderer(SDL_Window* pWindow);
+		//Headless: software only, draws into owned memory at any resolution without a window or DirectX.
+		//Frames are only read back through CaptureFrame
+		Renderer(int width, int height);
 		~Renderer();
 
 		Renderer(const Renderer&) = delete;
@@ -65,11 +48,11 @@ namespace dae
 
 		void Update(const Timer* pTimer);
 		void Render();
-		void SoftWareRender();
-		void HardwareRender();
 		void InitMesh(); 
 		void InitCamera();
 		void InitTexture();
+		//Blocks until the asset loader is done and swaps in every asset, for runs that need the final image right away
+		void WaitForAssets();
 
 
 		void SwitchTechnique();
@@ -83,8 +66,19 @@ namespace dae
 		void ToggleUniformClearColor();
 		void ToggleFireMesh();
 		void ToggleBoundingBoxVisualisation();
+		void ToggleTiledRendering();
+		void ToggleSimdKernel();
+		void SwitchTextureFilter();
+		void ToggleTexelLayout();
+		void ToggleHiZ();
+		void ToggleVisibilityBuffer();
+		void RequestBenchmark();
 
 		SystemMode GetSystemMode() { return m_CurrentSystemMode; }
+		bool IsHeadless() const { return m_pWindow == nullptr; }
+		void PrintFrameStats() const;
+		//Writes the last software frame as binary PPM, or as PNG when the path ends in .png
+		bool CaptureFrame(const std::string& path) const;
 
 	private:
 		SDL_Window* m_pWindow{};
@@ -94,30 +88,17 @@ namespace dae
 
 		float m_AspectRatio;
 
-		bool m_IsInitialized{ false };
 		bool m_IsRotating{ true };
-		bool m_UseNormals{ true };
 		bool m_ShowFireMesh{ true };
 		bool m_IsClearColorToggled{ false };
-		bool m_ShowBoundingBox{ false };
-		//DIRECTX
-		ID3D11Device* m_pDevice;
-		ID3D11DeviceContext* m_pDeviceContext;
-		IDXGISwapChain* m_pSwapChain;
-		ID3D11Texture2D* m_pDepthStencilBuffer;
-		ID3D11DepthStencilView* m_pDepthStencilView;
-		ID3D11Resource* m_pRenderTargetBuffer;
-		ID3D11RenderTargetView* m_pRenderTargetView;
-		ID3D11RasterizerState* m_pRasterizerState;
-
-		//Objects
-		Mesh* m_pVehicleMesh;
-		Mesh* m_pFireMesh;
+		bool m_IsBenchmarkRequested{ false };
+
+		//Objects, nullptr until the asset loader delivers them
+		Mesh* m_pVehicleMesh{ nullptr };
+		Mesh* m_pFireMesh{ nullptr };
 		Camera* m_pCamera;
 
 		//Modes
-		RenderMode m_CurrentRenderMode;
-		ColorMode m_CurrentColorMode;
 		SystemMode m_CurrentSystemMode;
 		CullFaceMode m_CurrentCullMode;
 
@@ -128,37 +109,35 @@ namespace dae
 		Texture* m_pSpecularTexture{ nullptr };
 		Texture* m_pFireTexture{ nullptr };
 
-		//Software data
-		SDL_Surface* m_pFrontBuffer{ nullptr };
-		SDL_Surface* m_pBackBuffer{ nullptr };
-		uint32_t* m_pBackBufferPixels{};
-		float* m_pDepthBufferPixels{};
-
-		void VertexTransformationFunction(); //W1 Version
-		bool IsInsideFrustrum(const Vector4& position);
-		void RenderTriangle(int idx0, int idx1, int idx2, std::vector<Vector2>& screenVerticesl, std::vector<Vertex_Out>& vertices_out, const std::vector<uint32_t>& indices);
-		ColorRGB PixelShading(const Vertex_Out& vertex_out);
-		ColorRGB Lambert(float kd, const ColorRGB& cd);
-		ColorRGB Phong(float ks, float exp, const Vector3& l, const Vector3& v, const Vector3& n);
-
-
-
-
-
-		//SDL_Surface* m_pFrontBuffer{ nullptr };
-		//SDL_Surface* m_pBackBuffer{ nullptr };
-		//uint32_t* m_pBackBufferPixels{};
-		//
-		//float* m_pDepthBufferPixels{};
-		//
-		//void VertexTransformationFunction(); //W1 Version
-		//bool IsInsideFrustrum(const Vector4& position);
-		//void RenderTriangle(int idx0, int idx1, int idx2, std::vector<Vector2>& screenVertices);
-		//ColorRGB PixelShading(const Vertex_Out& vertex_out);
-		//ColorRGB Lambert(float kd, const ColorRGB& cd);
-		//ColorRGB Phong(float ks, float exp, const Vector3& l, const Vector3& v, const Vector3& n);
-
-		HRESULT InitializeDirectX();
-		//...
+		//Asset loading: the texture members hold single texel placeholders and the meshes are not drawn
+		//until the loader resolves their futures, UpdatePendingAssets swaps them in at the start of a frame
+		struct PendingTexture
+		{
+			Texture** ppTexture;
+			std::future<TextureAsset> future;
+		};
+		AssetLoader* m_pAssetLoader{ nullptr };
+		std::vector<PendingTexture> m_PendingTextures{};
+		std::future<MeshAsset> m_VehicleMeshFuture{};
+		std::future<MeshAsset> m_FireMeshFuture{};
+		//Time to first frame and to the first frame with every asset, measured from the start of the constructor
+		std::chrono::steady_clock::time_point m_CreationTime{ std::chrono::steady_clock::now() };
+		bool m_IsFirstFramePresented{ false };
+
+		//Backends, both draw the scene BuildScene describes. Headless there is no hardware backend
+		HardwareBackend* m_pHardwareBackend{ nullptr };
+		SoftwareBackend* m_pSoftwareBackend{ nullptr };
+		//Where software frames go: the presenter of the window, or memory when headless
+		FramePresenter* m_pPresenter{ nullptr };
+		FrameTarget* m_pFrameTarget{ nullptr };
+
+		//Everything both constructors share, m_pWindow, m_Width and m_Height are set by then
+		void Initialize();
+		void UpdatePendingAssets(bool waitForAll);
+		Scene BuildScene() const;
+		void RunBenchmarks(const Scene& scene);
+		Matrix CreateMeshWorldMatrix() const;
+		size_t GetPendingAssetCount() const;
+		double GetMillisecondsSinceCreation() const;
 	};
 }
@@ -0,0 +1,27 @@
+#pragma once
+
+//Lets a translation unit compile SSE4.1/AVX2 functions next to scalar code without raising the baseline
+//of the whole build. Only call them after RasterKernels::DetectKernelType() reported support
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DAE_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+//MSVC allows every intrinsic regardless of /arch, the CPUID check decides what runs
+#define DAE_TARGET_SSE41
+#define DAE_TARGET_AVX2
+#else
+#include <cpuid.h>
+#define DAE_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define DAE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define DAE_SIMD_X86 0
+#endif
+
+//SSE2 is part of the x64 baseline (and the MSVC x86 default), so code can use it without a CPUID check
+#if DAE_SIMD_X86 && (defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define DAE_SIMD_SSE2 1
+#else
+#define DAE_SIMD_SSE2 0
+#endif
@@ -0,0 +1,1180 @@
+#include "pch.h"
+#include "SoftwareBackend.h"
+#include "AllocationCounter.h"
+#include "Clipper.h"
+#include "Mesh.h"
+#include "Utils.h"
+
+namespace dae
+{
+	namespace
+	{
+		using Clock = std::chrono::steady_clock;
+	}
+
+	SoftwareBackend::SoftwareBackend(int width, int height, FrameTarget* pFrameTarget) :
+		m_Width(width),
+		m_Height(height),
+		m_pFrameTarget(pFrameTarget)
+	{
+		m_pDepthBufferPixels = new float[m_Width * m_Height];
+		m_pRedBufferPixels = new float[m_Width * m_Height];
+		m_pGreenBufferPixels = new float[m_Width * m_Height];
+		m_pBlueBufferPixels = new float[m_Width * m_Height];
+
+		m_NumHiZBlocksX = (m_Width + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE;
+		m_NumHiZBlocksY = (m_Height + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE;
+		m_pHiZBufferPixels = new float[m_NumHiZBlocksX * m_NumHiZBlocksY];
+		m_pTriangleIdBufferPixels = new uint32_t[m_Width * m_Height];
+
+		m_NumTilesX = (m_Width + TILE_SIZE - 1) / TILE_SIZE;
+		m_NumTilesY = (m_Height + TILE_SIZE - 1) / TILE_SIZE;
+		m_IsTileClearPending.resize(static_cast<size_t>(m_NumTilesX) * m_NumTilesY);
+
+		//The render thread takes part in every ParallelFor, so it only needs helpers for the remaining cores
+		const uint32_t numCores{ std::max(std::thread::hardware_concurrency(), 1u) };
+		m_pThreadPool = new ThreadPool(numCores - 1);
+
+		m_KernelType = RasterKernels::DetectKernelType();
+		m_pSpanKernel = RasterKernels::GetSpanKernel(m_KernelType);
+		m_pTransformVertices = VertexStage::GetTransformFunction(m_KernelType);
+		m_pPackPixels = PixelPacking::GetPackFunction(m_KernelType);
+		std::cout << "Software rasterizer kernel: " << RasterKernels::GetKernelName(m_KernelType) << "\n";
+	}
+
+	SoftwareBackend::~SoftwareBackend()
+	{
+		delete[] m_pDepthBufferPixels;
+		delete[] m_pRedBufferPixels;
+		delete[] m_pGreenBufferPixels;
+		delete[] m_pBlueBufferPixels;
+		delete[] m_pHiZBufferPixels;
+		delete[] m_pTriangleIdBufferPixels;
+
+		delete m_pThreadPool;
+		m_pThreadPool = nullptr;
+	}
+
+	void SoftwareBackend::SwitchTextureFilter()
+	{
+		m_TextureFilter = static_cast<TextureFilter>((static_cast<int>(m_TextureFilter) + 1) % static_cast<int>(TextureFilter::END));
+		switch (m_TextureFilter)
+		{
+		case TextureFilter::Point:
+			std::cout << "Software texture filter: Point \n";
+			break;
+		case TextureFilter::Bilinear:
+			std::cout << "Software texture filter: Bilinear \n";
+			break;
+		case TextureFilter::Trilinear:
+			std::cout << "Software texture filter: Trilinear \n";
+			break;
+		default:
+			break;
+		}
+	}
+	void SoftwareBackend::ToggleTexelLayout()
+	{
+		m_TexelLayout = m_TexelLayout == TexelLayout::Tiled ? TexelLayout::Linear : TexelLayout::Tiled;
+
+		if (m_TexelLayout == TexelLayout::Tiled)
+			std::cout << "Software texel layout: 4x4 tiled \n";
+		else
+			std::cout << "Software texel layout: Linear \n";
+	}
+	void SoftwareBackend::SwitchRenderMode()
+	{
+		m_CurrentRenderMode = static_cast<RenderMode>((static_cast<int>(m_CurrentRenderMode) + 1) % (static_cast<int>(RenderMode::END)));
+		switch (m_CurrentRenderMode)
+		{
+		case RenderMode::Texture:
+			std::cout << "Current Rendermode: Texture \n";
+			break;
+		case RenderMode::DepthBuffer:
+			std::cout << "Current Rendermode: Depthbuffer \n";
+			break;
+		default:
+			break;
+		}
+	}
+	void SoftwareBackend::SwitchColorMode()
+	{
+		m_CurrentColorMode = static_cast<ColorMode>((static_cast<int>(m_CurrentColorMode) + 1) % (static_cast<int>(ColorMode::END) ));
+		switch (m_CurrentColorMode)
+		{
+		case dae::ColorMode::observedArea:
+			std::cout << "Current Colormode: ObservedArea.\n";
+			break;
+		case dae::ColorMode::Diffuse:
+			std::cout << "Current Rendermode: Diffuse \n";
+			break;
+		case dae::ColorMode::Specular:
+			std::cout << "Current Rendermode: Specular \n";
+			break;
+		case dae::ColorMode::Combined:
+			std::cout << "Current Rendermode: Combined \n";
+			break;
+		default:
+			break;
+		}
+	}
+	void SoftwareBackend::ToggleNormals()
+	{
+		m_UseNormals = !m_UseNormals;
+
+		if (m_UseNormals)
+			std::cout << "Normals on \n";
+		else
+			std::cout << "Normals off \n";
+	}
+	void SoftwareBackend::ToggleBoundingBoxVisualisation()
+	{
+		m_ShowBoundingBox = !m_ShowBoundingBox;
+
+		if (m_ShowBoundingBox)
+			std::cout << "Bounding box shown \n";
+		else
+			std::cout << "Bounding box hidden \n";
+	}
+	void SoftwareBackend::ToggleTiledRendering()
+	{
+		m_UseTiledRendering = !m_UseTiledRendering;
+
+		if (m_UseTiledRendering)
+			std::cout << "Tiled rendering on " << m_pThreadPool->GetNumThreads() << " threads \n";
+		else
+			std::cout << "Single threaded rendering \n";
+	}
+	void SoftwareBackend::ToggleSimdKernel()
+	{
+		if (!m_pSpanKernel)
+		{
+			std::cout << "No SIMD kernel supported on this CPU, using scalar \n";
+			return;
+		}
+
+		m_UseSimdKernel = !m_UseSimdKernel;
+
+		if (m_UseSimdKernel)
+			std::cout << "Rasterizer kernel: " << RasterKernels::GetKernelName(m_KernelType) << " \n";
+		else
+			std::cout << "Rasterizer kernel: Scalar \n";
+	}
+	void SoftwareBackend::ToggleHiZ()
+	{
+		m_UseHiZ = !m_UseHiZ;
+
+		if (m_UseHiZ)
+			std::cout << "HiZ block rejection on \n";
+		else
+			std::cout << "HiZ block rejection off \n";
+	}
+	void SoftwareBackend::ToggleVisibilityBuffer()
+	{
+		m_UseVisibilityBuffer = !m_UseVisibilityBuffer;
+
+		if (m_UseVisibilityBuffer)
+			std::cout << "Visibility buffer: depth + triangle id pass, then one shading pass \n";
+		else
+			std::cout << "Immediate shading \n";
+	}
+	void SoftwareBackend::PrintFrameStats() const
+	{
+		const uint64_t setupTriangles{ m_FrameStats.setupTriangles.load(std::memory_order_relaxed) };
+		const uint64_t culledTriangles{ m_FrameStats.culledTriangles.load(std::memory_order_relaxed) };
+		const uint64_t depthPassed{ m_FrameStats.depthPassedFragments.load(std::memory_order_relaxed) };
+		const uint64_t shaded{ m_FrameStats.shadedFragments.load(std::memory_order_relaxed) };
+
+		std::cout << "Triangles: " << setupTriangles << " set up, " << culledTriangles << " backface culled";
+		if (setupTriangles > 0)
+			std::cout << " (" << 100.0 * static_cast<double>(culledTriangles) / setupTriangles << "%)";
+		std::cout << ", " << m_RasterTriangles.size() << " rasterized\n";
+
+		const uint64_t rejectedBlocks{ m_FrameStats.rejectedBlocks.load(std::memory_order_relaxed) };
+		const uint64_t acceptedBlocks{ m_FrameStats.acceptedBlocks.load(std::memory_order_relaxed) };
+		const uint64_t partialBlocks{ m_FrameStats.partialBlocks.load(std::memory_order_relaxed) };
+		std::cout << HIZ_BLOCK_SIZE << "x" << HIZ_BLOCK_SIZE << " blocks: " << rejectedBlocks << " rejected, "
+			<< acceptedBlocks << " fully covered, " << partialBlocks << " partial\n";
+
+		std::cout << "Shading invocations: " << shaded << " (immediate mode: " << depthPassed;
+		if (depthPassed > 0)
+			std::cout << ", saved " << 100.0 * (1.0 - static_cast<double>(shaded) / depthPassed) << "%";
+		std::cout << ")\n";
+
+		if (AllocationCounter::IS_ENABLED)
+			std::cout << "Heap allocations: " << m_FrameStats.heapAllocations.load(std::memory_order_relaxed) << ", ";
+		std::cout << "Frame arena " << m_FrameArena.GetCapacity() / 1024 << " KB\n";
+
+		constexpr const char* stageNames[]{ "clear", "vertex", "setup", "binning", "raster", "pack", "present" };
+		static_assert(std::size(stageNames) == static_cast<size_t>(FrameStage::END), "Every stage needs a name");
+
+		std::cout << "Stage ms (clear, raster and pack summed over threads):";
+		for (int stage{}; stage < static_cast<int>(FrameStage::END); ++stage)
+			std::cout << " " << stageNames[stage] << " " << m_FrameStats.stageNanoseconds[stage].load(std::memory_order_relaxed) / 1e6;
+		std::cout << "\n";
+	}
+
+	void SoftwareBackend::Render(const Scene& scene)
+	{
+		m_FrameStats.Reset();
+		const uint64_t allocationsAtFrameStart{ AllocationCounter::GetCount() };
+
+		//Nothing is cleared here, every tile resolves its own clear when a triangle first touches it
+		m_ClearColor = scene.isClearColorToggled ? 0.1f : 0.39f;
+		std::fill(m_IsTileClearPending.begin(), m_IsTileClearPending.end(), uint8_t{ 1 });
+		m_CurrentCullMode = scene.cullMode;
+		m_Material = scene.opaque.material;
+
+		//Until the loader delivers the mesh the frame is just the clear color
+		const Mesh* pMesh{ scene.opaque.pMesh };
+		if (pMesh == nullptr)
+		{
+			AcquireBackBuffer();
+			for (uint32_t tileIdx = 0; tileIdx < m_IsTileClearPending.size(); ++tileIdx)
+				PackTile(tileIdx);
+			PresentBackBuffer();
+			return;
+		}
+
+		m_FrameArena.Reset();
+
+		const Matrix worldMatrix{ pMesh->GetWorldMatrix() };
+		const Matrix worldViewProjectionMatrix{ worldMatrix * scene.viewMatrix * scene.projectionMatrix };
+
+		Clock::time_point stageStart{ Clock::now() };
+		VertexTransformationFunction(*pMesh, worldViewProjectionMatrix);
+		m_FrameStats.AddStageTime(FrameStage::VertexTransformation, Clock::now() - stageStart);
+		stageStart = Clock::now();
+
+		//m_TransformedVertices keeps the clip space positions for the clipper, the copy is divided for the rasterizer
+		const std::span<const Vertex_Out> clipVertices{ m_TransformedVertices };
+		const std::span<const uint32_t> meshIndices{ pMesh->GetIndices() };
+		std::span<Vertex_Out> meshVerticesOut{ m_FrameArena.Copy(clipVertices) };
+		std::span<Int2> raster_Vertices{ m_FrameArena.Allocate<Int2>(meshVerticesOut.size()) };
+
+		for (size_t i{}; i < meshVerticesOut.size(); ++i)
+		{
+			raster_Vertices[i] = ProjectVertex(meshVerticesOut[i]);
+		}
+
+		//Triangle setup
+		m_RasterTriangles.clear();
+		m_ClippedVertices.clear();
+		m_ClippedScreenVertices.clear();
+		m_ClippedIndices.clear();
+		switch (pMesh->GetTopology())
+		{
+		case PrimitiveTopology::TriangleStrip:
+			for (size_t i = 0; i + 2 < meshIndices.size(); ++i)
+			{
+				int idx0{ static_cast<int>(i) };
+				int idx1{ static_cast<int>(i + 1) };
+				int idx2{ static_cast<int>(i + 2) };
+
+				if ((i ^ 1) != i + 1)
+				{
+					int temp = idx1;
+					idx1 = idx2;
+					idx2 = temp;
+				}
+				SetupTriangle(idx0, idx1, idx2, clipVertices, raster_Vertices, meshIndices);
+
+			}
+
+			break;
+		case PrimitiveTopology::TriangleList:
+			for (size_t i = 0; i + 2 < meshIndices.size(); i += 3)
+			{
+				int idx0{ static_cast<int>(i) };
+				int idx1{ static_cast<int>(i + 1) };
+				int idx2{ static_cast<int>(i + 2) };
+
+				SetupTriangle(idx0, idx1, idx2, clipVertices, raster_Vertices, meshIndices);
+			}
+			break;
+		}
+
+		//Triangles made by the clipper index past the end of the mesh buffers,
+		//without clipping the rasterizer reads the mesh indices directly
+		std::span<const uint32_t> rasterIndices{ meshIndices };
+		if (!m_ClippedIndices.empty())
+		{
+			rasterIndices = m_FrameArena.Concatenate<uint32_t>(meshIndices, m_ClippedIndices);
+			meshVerticesOut = m_FrameArena.Concatenate<Vertex_Out>(meshVerticesOut, m_ClippedVertices);
+			raster_Vertices = m_FrameArena.Concatenate<Int2>(raster_Vertices, m_ClippedScreenVertices);
+		}
+		m_RasterVertices = raster_Vertices;
+		m_RasterIndices = rasterIndices;
+		m_FrameStats.AddStageTime(FrameStage::TriangleSetup, Clock::now() - stageStart);
+
+		//Nothing before rasterization writes the back buffer, so the previous frame gets as long as possible to present
+		AcquireBackBuffer();
+
+		//Rasterization, the render state is resolved here once instead of per pixel
+		const RasterPipeline pipeline{ SelectRasterPipeline() };
+		if (m_UseTiledRendering)
+		{
+			stageStart = Clock::now();
+			BinTriangles();
+			m_FrameStats.AddStageTime(FrameStage::Binning, Clock::now() - stageStart);
+
+			//Every tile clears, rasterizes and packs itself, see RenderTile
+			m_pThreadPool->ParallelFor(static_cast<uint32_t>(m_NumTilesX * m_NumTilesY), [&](uint32_t tileIdx)
+				{
+					RenderTile(tileIdx, pipeline, raster_Vertices, meshVerticesOut, rasterIndices);
+				});
+		}
+		else
+		{
+			const Clock::time_point clearStart{ Clock::now() };
+			for (const RasterTriangle& triangle : m_RasterTriangles)
+				ResolveTileClears(triangle);
+
+			const Clock::time_point rasterStart{ Clock::now() };
+			for (uint32_t triangleIdx = 0; triangleIdx < m_RasterTriangles.size(); ++triangleIdx)
+				(this->*pipeline.pRenderTriangle)(triangleIdx, raster_Vertices, meshVerticesOut, rasterIndices, Int2{ 0, 0 }, Int2{ m_Width, m_Height });
+
+			//Tiles no triangle touched still hold the triangle ids of an older frame
+			const uint32_t numTiles{ static_cast<uint32_t>(m_IsTileClearPending.size()) };
+			for (uint32_t tileIdx = 0; pipeline.pResolve && tileIdx < numTiles; ++tileIdx)
+			{
+				if (!m_IsTileClearPending[tileIdx])
+					(this->*pipeline.pResolve)(raster_Vertices, meshVerticesOut, rasterIndices, GetTileMin(tileIdx), GetTileMax(tileIdx));
+			}
+
+			const Clock::time_point packStart{ Clock::now() };
+			for (uint32_t tileIdx = 0; tileIdx < numTiles; ++tileIdx)
+				PackTile(tileIdx);
+
+			m_FrameStats.AddStageTime(FrameStage::Clear, rasterStart - clearStart);
+			m_FrameStats.AddStageTime(FrameStage::Rasterization, packStart - rasterStart);
+			m_FrameStats.AddStageTime(FrameStage::Pack, Clock::now() - packStart);
+		}
+		m_FrameStats.heapAllocations.store(AllocationCounter::GetCount() - allocationsAtFrameStart, std::memory_order_relaxed);
+
+		PresentBackBuffer();
+	}
+	void SoftwareBackend::AcquireBackBuffer()
+	{
+		//Time spent waiting for the frame target (the present thread of the window) counts as present time
+		const Clock::time_point acquireStart{ Clock::now() };
+		m_pBackBufferPixels = m_pFrameTarget->AcquireFrame();
+		m_FrameStats.AddStageTime(FrameStage::Present, Clock::now() - acquireStart);
+	}
+	void SoftwareBackend::PresentBackBuffer()
+	{
+		//A window target blits the RGBA32 frame to the window format on its own thread while the next frame is drawn
+		const Clock::time_point presentStart{ Clock::now() };
+		m_pFrameTarget->SubmitFrame();
+		m_FrameStats.AddStageTime(FrameStage::Present, Clock::now() - presentStart);
+	}
+	void SoftwareBackend::VertexTransformationFunction(const Mesh& mesh, const Matrix& worldViewProjectionMatrix)
+	{
+		//Todo > W1 Projection Stage
+		m_TransformedVertices.resize(mesh.GetVertices().size());
+
+		VertexStage::TransformVertices(m_pTransformVertices, mesh.GetVertexStreams(), mesh.GetVertices(),
+			worldViewProjectionMatrix, mesh.GetWorldMatrix(), m_TransformedVertices.data(), *m_pThreadPool);
+	}
+	Int2 SoftwareBackend::ProjectVertex(Vertex_Out& vertex) const
+	{
+		vertex.position.x /= vertex.position.w;
+		vertex.position.y /= vertex.position.w;
+		vertex.position.z /= vertex.position.w;
+
+		//Vertices behind the camera are projected too but only ever used through the clipper, the clamp keeps
+		//their conversion defined. A vertex at w == 0 can divide to NaN, which passes any clamp, so it snaps to 0
+		auto toFixedPoint = [](float value)
+			{
+				constexpr float maxFixedPoint{ static_cast<float>(1 << 24) };
+				if (std::isnan(value))
+					return 0;
+				return static_cast<int>(std::lround(std::clamp(value, -maxFixedPoint, maxFixedPoint)));
+			};
+
+		return Int2{ toFixedPoint((vertex.position.x + 1) * 0.5f * m_Width * SUBPIXEL_SCALE),
+			toFixedPoint((1 - vertex.position.y) * 0.5f * m_Height * SUBPIXEL_SCALE) };
+	}
+
+	void SoftwareBackend::SetupTriangle(int idx0, int idx1, int idx2, std::span<const Vertex_Out> clipVertices,
+		std::span<const Int2> screenVertices, std::span<const uint32_t> indices)
+	{
+		const Vertex_Out& v0{ clipVertices[indices[idx0]] };
+		const Vertex_Out& v1{ clipVertices[indices[idx1]] };
+		const Vertex_Out& v2{ clipVertices[indices[idx2]] };
+
+		m_FrameStats.setupTriangles.fetch_add(1, std::memory_order_relaxed);
+
+		//Completely outside one side of the view volume
+		if (Clipper::ComputeOutCode(v0.position, 1.f) & Clipper::ComputeOutCode(v1.position, 1.f) & Clipper::ComputeOutCode(v2.position, 1.f))
+			return;
+
+		//Inside near/far and the guard band: rasterize as is, the bounding box takes care of the screen edges
+		const uint8_t clipPlanes{ static_cast<uint8_t>(
+			Clipper::ComputeOutCode(v0.position, Clipper::GUARD_BAND) |
+			Clipper::ComputeOutCode(v1.position, Clipper::GUARD_BAND) |
+			Clipper::ComputeOutCode(v2.position, Clipper::GUARD_BAND)) };
+		if (clipPlanes == 0)
+		{
+			AddRasterTriangle(idx0, idx1, idx2, screenVertices[indices[idx0]], screenVertices[indices[idx1]], screenVertices[indices[idx2]]);
+			return;
+		}
+
+		Vertex_Out polygon[Clipper::MAX_POLYGON_VERTICES];
+		const int polygonCount{ Clipper::ClipTriangle(v0, v1, v2, clipPlanes, polygon) };
+		if (polygonCount < 3)
+			return;
+
+		//New vertices and indices go after the mesh ones, Render appends them before rasterizing
+		const int firstVertex{ static_cast<int>(clipVertices.size() + m_ClippedVertices.size()) };
+		const int firstIndex{ static_cast<int>(indices.size() + m_ClippedIndices.size()) };
+		const size_t firstClippedVertex{ m_ClippedScreenVertices.size() };
+
+		for (int i{}; i < polygonCount; ++i)
+		{
+			m_ClippedScreenVertices.push_back(ProjectVertex(polygon[i]));
+			m_ClippedVertices.push_back(polygon[i]);
+		}
+
+		//Fan around the first vertex
+		for (int i{ 1 }; i + 1 < polygonCount; ++i)
+		{
+			m_ClippedIndices.push_back(firstVertex);
+			m_ClippedIndices.push_back(firstVertex + i);
+			m_ClippedIndices.push_back(firstVertex + i + 1);
+
+			const int triangleIdx{ firstIndex + 3 * (i - 1) };
+			AddRasterTriangle(triangleIdx, triangleIdx + 1, triangleIdx + 2,
+				m_ClippedScreenVertices[firstClippedVertex],
+				m_ClippedScreenVertices[firstClippedVertex + i],
+				m_ClippedScreenVertices[firstClippedVertex + i + 1]);
+		}
+	}
+
+	void SoftwareBackend::AddRasterTriangle(int idx0, int idx1, int idx2, const Int2& p0, const Int2& p1, const Int2& p2)
+	{
+		//Backface culling on the sign of the snapped area, decided once here instead of for every pixel.
+		//Positive is clockwise on screen (y points down)
+		const int64_t doubleArea{ static_cast<int64_t>(p1.x - p0.x) * (p2.y - p1.y) - static_cast<int64_t>(p1.y - p0.y) * (p2.x - p1.x) };
+		if (doubleArea == 0)
+			return;
+
+		const bool isCulled{ (m_CurrentCullMode == CullFaceMode::Back && doubleArea < 0) ||
+			(m_CurrentCullMode == CullFaceMode::Front && doubleArea > 0) };
+		if (isCulled)
+		{
+			m_FrameStats.culledTriangles.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		const Int2 Min{ std::min(p0.x, std::min(p1.x, p2.x)), std::min(p0.y, std::min(p1.y, p2.y)) };
+		const Int2 Max{ std::max(p0.x, std::max(p1.x, p2.x)), std::max(p0.y, std::max(p1.y, p2.y)) };
+
+		//Pixel px is sampled at px * SUBPIXEL_SCALE, so round the fixed point box inwards
+		RasterTriangle triangle{ idx0, idx1, idx2 };
+		triangle.min.x = std::clamp((Min.x + SUBPIXEL_SCALE - 1) >> SUBPIXEL_BITS, 0, m_Width);
+		triangle.min.y = std::clamp((Min.y + SUBPIXEL_SCALE - 1) >> SUBPIXEL_BITS, 0, m_Height);
+		triangle.max.x = std::clamp((Max.x >> SUBPIXEL_BITS) + 1, 0, m_Width);
+		triangle.max.y = std::clamp((Max.y >> SUBPIXEL_BITS) + 1, 0, m_Height);
+
+		if (triangle.min.x >= triangle.max.x || triangle.min.y >= triangle.max.y)
+			return;
+
+		m_RasterTriangles.push_back(triangle);
+	}
+
+	EdgeEquations SoftwareBackend::SetupEdgeEquations(const Int2& p0, const Int2& p1, const Int2& p2)
+	{
+		EdgeEquations equations{};
+
+		//Cross(pb - pa, sample - pa) with the sample at (px, py) * SUBPIXEL_SCALE, edge i is the one opposite vertex i
+		const Int2* pEdgeStart[3]{ &p1, &p2, &p0 };
+		const Int2* pEdgeEnd[3]{ &p2, &p0, &p1 };
+
+		const int64_t e0x{ p1.x - p0.x };
+		const int64_t e0y{ p1.y - p0.y };
+		const int64_t e1x{ p2.x - p1.x };
+		const int64_t e1y{ p2.y - p1.y };
+		equations.doubleArea = e0x * e1y - e0y * e1x;
+
+		//Culling already happened in setup, so both windings are flipped to positive here:
+		//the weights E / area are unchanged and coverage is a single "all above threshold" test
+		const int64_t sign{ equations.doubleArea < 0 ? -1 : 1 };
+		equations.doubleArea *= sign;
+
+		for (int i{}; i < 3; ++i)
+		{
+			const int64_t edgeX{ (pEdgeEnd[i]->x - pEdgeStart[i]->x) * sign };
+			const int64_t edgeY{ (pEdgeEnd[i]->y - pEdgeStart[i]->y) * sign };
+
+			equations.a[i] = -edgeY * SUBPIXEL_SCALE;
+			equations.b[i] = edgeX * SUBPIXEL_SCALE;
+			equations.c[i] = edgeY * pEdgeStart[i]->x - edgeX * pEdgeStart[i]->y;
+
+			//Top-left rule: a sample exactly on an edge belongs to the triangle only for a left edge
+			//(inside lies towards +x) or a top edge (horizontal, inside lies towards +y since y points down),
+			//so a sample on an edge shared by two triangles is covered by exactly one of them
+			const bool isTopLeft{ edgeY < 0 || (edgeY == 0 && edgeX > 0) };
+			equations.threshold[i] = isTopLeft ? -1 : 0;
+		}
+		return equations;
+	}
+
+	void SoftwareBackend::BinTriangles()
+	{
+		//Counting sort into the frame arena: count the triangles of every tile, turn the counts into offsets, then fill.
+		//Both passes visit the triangles in submission order, so every bin keeps the original draw order
+		const size_t numTiles{ static_cast<size_t>(m_NumTilesX) * m_NumTilesY };
+		const auto forEachOverlappedTile{ [this](auto&& visit)
+			{
+				for (uint32_t triangleIdx = 0; triangleIdx < m_RasterTriangles.size(); ++triangleIdx)
+				{
+					const RasterTriangle& triangle{ m_RasterTriangles[triangleIdx] };
+
+					const int firstTileX{ triangle.min.x / TILE_SIZE };
+					const int firstTileY{ triangle.min.y / TILE_SIZE };
+					const int lastTileX{ (triangle.max.x - 1) / TILE_SIZE };
+					const int lastTileY{ (triangle.max.y - 1) / TILE_SIZE };
+
+					for (int tileY{ firstTileY }; tileY <= lastTileY; ++tileY)
+					{
+						for (int tileX{ firstTileX }; tileX <= lastTileX; ++tileX)
+						{
+							visit(triangleIdx, static_cast<size_t>(tileX + tileY * m_NumTilesX));
+						}
+					}
+				}
+			} };
+
+		m_TileBinOffsets = m_FrameArena.Allocate<uint32_t>(numTiles + 1);
+		std::fill(m_TileBinOffsets.begin(), m_TileBinOffsets.end(), 0u);
+		forEachOverlappedTile([this](uint32_t, size_t tileIdx) { ++m_TileBinOffsets[tileIdx + 1]; });
+
+		for (size_t tileIdx{ 1 }; tileIdx <= numTiles; ++tileIdx)
+			m_TileBinOffsets[tileIdx] += m_TileBinOffsets[tileIdx - 1];
+
+		m_TileBinTriangles = m_FrameArena.Allocate<uint32_t>(m_TileBinOffsets[numTiles]);
+		const std::span<uint32_t> writePositions{ m_FrameArena.Copy<uint32_t>(m_TileBinOffsets.first(numTiles)) };
+		forEachOverlappedTile([&](uint32_t triangleIdx, size_t tileIdx) { m_TileBinTriangles[writePositions[tileIdx]++] = triangleIdx; });
+	}
+
+	SoftwareBackend::RasterPipeline SoftwareBackend::SelectRasterPipeline() const
+	{
+		if (m_ShowBoundingBox)
+			return RasterPipeline{ &SoftwareBackend::RenderTriangleBoundingBox, nullptr };
+
+		//Culling is done in triangle setup, so the cull mode needs no instantiations of its own
+		if (m_CurrentRenderMode == RenderMode::DepthBuffer)
+			return MakeRasterPipeline<RenderMode::DepthBuffer, ColorMode::observedArea, false>();
+
+		switch (m_CurrentColorMode)
+		{
+		case dae::ColorMode::observedArea:
+			return SelectRasterPipeline<ColorMode::observedArea>();
+		case dae::ColorMode::Diffuse:
+			return SelectRasterPipeline<ColorMode::Diffuse>();
+		case dae::ColorMode::Specular:
+			return SelectRasterPipeline<ColorMode::Specular>();
+		default:
+			return SelectRasterPipeline<ColorMode::Combined>();
+		}
+	}
+
+	template<ColorMode COLOR_MODE>
+	SoftwareBackend::RasterPipeline SoftwareBackend::SelectRasterPipeline() const
+	{
+		//Without a normal map the interpolated vertex normal is all there is
+		if (m_UseNormals && m_Material.pNormal != nullptr)
+			return MakeRasterPipeline<RenderMode::Texture, COLOR_MODE, true>();
+		return MakeRasterPipeline<RenderMode::Texture, COLOR_MODE, false>();
+	}
+
+	template<RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+	SoftwareBackend::RasterPipeline SoftwareBackend::MakeRasterPipeline() const
+	{
+		//The visibility pass never shades, so it only needs one instantiation
+		if (m_UseVisibilityBuffer)
+		{
+			return RasterPipeline{
+				&SoftwareBackend::RenderTriangle<true, RenderMode::DepthBuffer, ColorMode::observedArea, false>,
+				&SoftwareBackend::ResolveVisibilityBuffer<RENDER_MODE, COLOR_MODE, USE_NORMALS> };
+		}
+		return RasterPipeline{ &SoftwareBackend::RenderTriangle<false, RENDER_MODE, COLOR_MODE, USE_NORMALS>, nullptr };
+	}
+
+	void SoftwareBackend::RenderTile(uint32_t tileIdx, const RasterPipeline& pipeline, std::span<const Int2> screenVertices,
+		std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices)
+	{
+		//Tiles never overlap, so every thread owns its part of the color and depth buffer
+		const Int2 tileMin{ GetTileMin(tileIdx) };
+		const Int2 tileMax{ GetTileMax(tileIdx) };
+
+		//A tile without triangles is never cleared, PackTile writes the clear color straight to the back buffer
+		const uint32_t binBegin{ m_TileBinOffsets[tileIdx] };
+		const uint32_t binEnd{ m_TileBinOffsets[tileIdx + 1] };
+		if (binBegin != binEnd)
+		{
+			const Clock::time_point clearStart{ Clock::now() };
+			ResolveTileClear(tileIdx);
+
+			const Clock::time_point rasterStart{ Clock::now() };
+			for (uint32_t triangleIdx : m_TileBinTriangles.subspan(binBegin, binEnd - binBegin))
+				(this->*pipeline.pRenderTriangle)(triangleIdx, screenVertices, vertices_out, indices, tileMin, tileMax);
+
+			//Every triangle of this tile has been drawn, so its visibility is final
+			if (pipeline.pResolve)
+				(this->*pipeline.pResolve)(screenVertices, vertices_out, indices, tileMin, tileMax);
+
+			m_FrameStats.AddStageTime(FrameStage::Clear, rasterStart - clearStart);
+			m_FrameStats.AddStageTime(FrameStage::Rasterization, Clock::now() - rasterStart);
+		}
+
+		//Packed while the tile's colors are still in this core's cache
+		const Clock::time_point packStart{ Clock::now() };
+		PackTile(tileIdx);
+		m_FrameStats.AddStageTime(FrameStage::Pack, Clock::now() - packStart);
+	}
+
+	Int2 SoftwareBackend::GetTileMin(uint32_t tileIdx) const
+	{
+		return Int2{ static_cast<int>(tileIdx) % m_NumTilesX * TILE_SIZE, static_cast<int>(tileIdx) / m_NumTilesX * TILE_SIZE };
+	}
+
+	Int2 SoftwareBackend::GetTileMax(uint32_t tileIdx) const
+	{
+		const Int2 tileMin{ GetTileMin(tileIdx) };
+		return Int2{ std::min(tileMin.x + TILE_SIZE, m_Width), std::min(tileMin.y + TILE_SIZE, m_Height) };
+	}
+
+	void SoftwareBackend::ResolveTileClear(uint32_t tileIdx)
+	{
+		if (!m_IsTileClearPending[tileIdx])
+			return;
+		m_IsTileClearPending[tileIdx] = 0;
+
+		const Int2 tileMin{ GetTileMin(tileIdx) };
+		const Int2 tileMax{ GetTileMax(tileIdx) };
+		const int tileWidth{ tileMax.x - tileMin.x };
+		for (int py{ tileMin.y }; py < tileMax.y; ++py)
+		{
+			const int rowStart{ tileMin.x + (py * m_Width) };
+			std::fill_n(m_pDepthBufferPixels + rowStart, tileWidth, FLT_MAX);
+			std::fill_n(m_pRedBufferPixels + rowStart, tileWidth, m_ClearColor);
+			std::fill_n(m_pGreenBufferPixels + rowStart, tileWidth, m_ClearColor);
+			std::fill_n(m_pBlueBufferPixels + rowStart, tileWidth, m_ClearColor);
+			if (m_UseVisibilityBuffer)
+				std::fill_n(m_pTriangleIdBufferPixels + rowStart, tileWidth, INVALID_TRIANGLE_ID);
+		}
+
+		//The tile starts on a HiZ block, at the screen edge its last blocks are partial
+		const int firstBlockX{ tileMin.x / HIZ_BLOCK_SIZE };
+		const int blockCountX{ (tileWidth + HIZ_BLOCK_SIZE - 1) / HIZ_BLOCK_SIZE };
+		for (int blockY{ tileMin.y / HIZ_BLOCK_SIZE }; blockY * HIZ_BLOCK_SIZE < tileMax.y; ++blockY)
+			std::fill_n(m_pHiZBufferPixels + firstBlockX + (blockY * m_NumHiZBlocksX), blockCountX, FLT_MAX);
+	}
+
+	void SoftwareBackend::ResolveTileClears(const RasterTriangle& triangle)
+	{
+		const int lastTileX{ (triangle.max.x - 1) / TILE_SIZE };
+		const int lastTileY{ (triangle.max.y - 1) / TILE_SIZE };
+		for (int tileY{ triangle.min.y / TILE_SIZE }; tileY <= lastTileY; ++tileY)
+		{
+			for (int tileX{ triangle.min.x / TILE_SIZE }; tileX <= lastTileX; ++tileX)
+				ResolveTileClear(static_cast<uint32_t>(tileX + tileY * m_NumTilesX));
+		}
+	}
+
+	void SoftwareBackend::PackTile(uint32_t tileIdx)
+	{
+		const Int2 tileMin{ GetTileMin(tileIdx) };
+		const Int2 tileMax{ GetTileMax(tileIdx) };
+		const int tileWidth{ tileMax.x - tileMin.x };
+
+		//Nothing was drawn here this frame
+		if (m_IsTileClearPending[tileIdx])
+		{
+			const uint32_t clearPixel{ PixelPacking::PackColor(m_ClearColor, m_ClearColor, m_ClearColor) };
+			for (int py{ tileMin.y }; py < tileMax.y; ++py)
+				std::fill_n(m_pBackBufferPixels + tileMin.x + (py * m_Width), tileWidth, clearPixel);
+			return;
+		}
+
+		for (int py{ tileMin.y }; py < tileMax.y; ++py)
+		{
+			const int rowStart{ tileMin.x + (py * m_Width) };
+			m_pPackPixels(m_pRedBufferPixels + rowStart, m_pGreenBufferPixels + rowStart, m_pBlueBufferPixels + rowStart, tileWidth, m_pBackBufferPixels + rowStart);
+		}
+	}
+
+	//Same signature as RenderTriangle to fit in a RasterPipeline, the box only needs the setup data of the triangle
+	void SoftwareBackend::RenderTriangleBoundingBox(uint32_t triangleIdx, [[maybe_unused]] std::span<const Int2> screenVertices,
+		[[maybe_unused]] std::span<const Vertex_Out> vertices_out, [[maybe_unused]] std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax)
+	{
+		const RasterTriangle& triangle{ m_RasterTriangles[triangleIdx] };
+
+		const int startX{ std::max(triangle.min.x, clipMin.x) };
+		const int startY{ std::max(triangle.min.y, clipMin.y) };
+		const int endX{ std::min(triangle.max.x, clipMax.x) };
+		const int endY{ std::min(triangle.max.y, clipMax.y) };
+
+		for (int py{ startY }; py < endY; ++py)
+		{
+			const int rowStart{ startX + (py * m_Width) };
+			std::fill_n(m_pRedBufferPixels + rowStart, endX - startX, 1.f);
+			std::fill_n(m_pGreenBufferPixels + rowStart, endX - startX, 1.f);
+			std::fill_n(m_pBlueBufferPixels + rowStart, endX - startX, 1.f);
+		}
+	}
+
+	template<bool WRITE_TRIANGLE_ID, RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+	void SoftwareBackend::RenderTriangle(uint32_t triangleIdx, std::span<const Int2> screenVertices,
+		std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax)
+	{
+		const RasterTriangle& triangle{ m_RasterTriangles[triangleIdx] };
+		const int idx0{ triangle.idx0 };
+		const int idx1{ triangle.idx1 };
+		const int idx2{ triangle.idx2 };
+
+		//Degenerate and culled triangles never got here, see AddRasterTriangle
+		const EdgeEquations edges{ SetupEdgeEquations(screenVertices[indices[idx0]], screenVertices[indices[idx1]], screenVertices[indices[idx2]]) };
+		const float invTriangleArea{ 1.f / static_cast<float>(edges.doubleArea) };
+
+		const int startX{ std::max(triangle.min.x, clipMin.x) };
+		const int startY{ std::max(triangle.min.y, clipMin.y) };
+		const int endX{ std::min(triangle.max.x, clipMax.x) };
+		const int endY{ std::min(triangle.max.y, clipMax.y) };
+
+		const Vertex_Out& v0{ vertices_out[indices[idx0]] };
+		const Vertex_Out& v1{ vertices_out[indices[idx1]] };
+		const Vertex_Out& v2{ vertices_out[indices[idx2]] };
+
+		const float depthZV0{ v0.position.z };
+		const float depthZV1{ v1.position.z };
+		const float depthZV2{ v2.position.z };
+
+		//The SIMD span kernel steps the same integer edges in float. While every edges.a is below 2^24 / HIZ_BLOCK_SIZE,
+		//every value near zero over a span of at most HIZ_BLOCK_SIZE pixels is an integer below 2^24 and exact:
+		//the kernel coverage matches the integer test. edges.a is 16x the edge height in 28.4, so within the guard band
+		//taller screens can break the bound, those triangles take the integer loop instead
+		constexpr int64_t maxExactEdgeStep{ (int64_t{ 1 } << 24) / HIZ_BLOCK_SIZE };
+		const bool isFloatSteppingExact{ std::abs(edges.a[0]) < maxExactEdgeStep && std::abs(edges.a[1]) < maxExactEdgeStep
+			&& std::abs(edges.a[2]) < maxExactEdgeStep };
+
+		SpanSetup spanSetup{};
+		spanSetup.edgeStep[0] = static_cast<float>(edges.a[0]);
+		spanSetup.edgeStep[1] = static_cast<float>(edges.a[1]);
+		spanSetup.edgeStep[2] = static_cast<float>(edges.a[2]);
+		spanSetup.edgeThreshold[0] = static_cast<float>(edges.threshold[0]);
+		spanSetup.edgeThreshold[1] = static_cast<float>(edges.threshold[1]);
+		spanSetup.edgeThreshold[2] = static_cast<float>(edges.threshold[2]);
+		spanSetup.invTriangleArea = invTriangleArea;
+		spanSetup.invDepthZ[0] = 1.f / depthZV0;
+		spanSetup.invDepthZ[1] = 1.f / depthZV1;
+		spanSetup.invDepthZ[2] = 1.f / depthZV2;
+		spanSetup.invDepthW[0] = 1.f / v0.position.w;
+		spanSetup.invDepthW[1] = 1.f / v1.position.w;
+		spanSetup.invDepthW[2] = 1.f / v2.position.w;
+
+		const RasterKernels::SpanKernel pSpanKernel{ m_UseSimdKernel && isFloatSteppingExact ? m_pSpanKernel : nullptr };
+		SpanFragments fragments;
+
+		//The interpolated depth never leaves the range of the vertex depths,
+		//so a HiZ block whose farthest depth is closer than this hides the whole triangle there
+		const float nearestDepth{ std::min(depthZV0, std::min(depthZV1, depthZV2)) };
+
+		const int firstBlockX{ startX / HIZ_BLOCK_SIZE };
+		const int firstBlockY{ startY / HIZ_BLOCK_SIZE };
+		const int lastBlockX{ (endX - 1) / HIZ_BLOCK_SIZE };
+		const int lastBlockY{ (endY - 1) / HIZ_BLOCK_SIZE };
+
+		uint64_t depthPassedFragments{};
+		uint64_t rejectedBlocks{};
+		uint64_t acceptedBlocks{};
+		uint64_t partialBlocks{};
+
+		//RENDER LOGIC
+		for (int blockY{ firstBlockY }; blockY <= lastBlockY; ++blockY)
+		{
+			const int blockStartY{ std::max(startY, blockY * HIZ_BLOCK_SIZE) };
+			const int blockEndY{ std::min(endY, (blockY + 1) * HIZ_BLOCK_SIZE) };
+
+			for (int blockX{ firstBlockX }; blockX <= lastBlockX; ++blockX)
+			{
+				float& blockMaxDepth{ m_pHiZBufferPixels[blockX + (blockY * m_NumHiZBlocksX)] };
+				if (m_UseHiZ && nearestDepth > blockMaxDepth)
+					continue;
+
+				const int blockStartX{ std::max(startX, blockX * HIZ_BLOCK_SIZE) };
+				const int blockEndX{ std::min(endX, (blockX + 1) * HIZ_BLOCK_SIZE) };
+
+				//Long thin triangles leave most blocks of their bounding box empty, and big ones cover most of theirs
+				const BlockCoverage blockCoverage{ edges.ClassifyBlock(blockStartX, blockStartY, blockEndX - 1, blockEndY - 1) };
+				if (blockCoverage == BlockCoverage::Outside)
+				{
+					++rejectedBlocks;
+					continue;
+				}
+
+				const bool isBlockInside{ blockCoverage == BlockCoverage::Inside };
+				if (isBlockInside)
+					++acceptedBlocks;
+				else
+					++partialBlocks;
+				spanSetup.isFullyCovered = isBlockInside;
+
+				bool isDepthWritten{ false };
+				for (int py{ blockStartY }; py < blockEndY; ++py)
+				{
+					//Exact in integers, so tiles and threads agree on every pixel
+					int64_t currEdge0{ edges.Evaluate(0, blockStartX, py) };
+					int64_t currEdge1{ edges.Evaluate(1, blockStartX, py) };
+					int64_t currEdge2{ edges.Evaluate(2, blockStartX, py) };
+
+					if (pSpanKernel)
+					{
+						spanSetup.edge[0] = static_cast<float>(currEdge0);
+						spanSetup.edge[1] = static_cast<float>(currEdge1);
+						spanSetup.edge[2] = static_cast<float>(currEdge2);
+
+						uint64_t spanMask{ pSpanKernel(spanSetup, blockEndX - blockStartX, m_pDepthBufferPixels + blockStartX + (py * m_Width), fragments) };
+						isDepthWritten |= spanMask != 0;
+						depthPassedFragments += std::popcount(spanMask);
+
+						while (spanMask != 0)
+						{
+							const int offset{ std::countr_zero(spanMask) };
+							spanMask &= spanMask - 1;
+
+							if constexpr (WRITE_TRIANGLE_ID)
+							{
+								m_pTriangleIdBufferPixels[blockStartX + offset + (py * m_Width)] = triangleIdx;
+							}
+							else
+							{
+								ShadePixel<RENDER_MODE, COLOR_MODE, USE_NORMALS>(blockStartX + offset, py, edges, v0, v1, v2,
+									fragments.weight0[offset], fragments.weight1[offset], fragments.weight2[offset],
+									fragments.depthZ[offset], fragments.depthW[offset]);
+							}
+						}
+						continue;
+					}
+
+					//Walk along the row so the buffers are accessed in memory order
+					for (int px{ blockStartX }; px < blockEndX; ++px, currEdge0 += edges.a[0], currEdge1 += edges.a[1], currEdge2 += edges.a[2])
+					{
+						if (!isBlockInside && !(currEdge0 > edges.threshold[0] && currEdge1 > edges.threshold[1] && currEdge2 > edges.threshold[2]))
+							continue;
+
+						float weight0 = static_cast<float>(currEdge0) * invTriangleArea;
+						float weight1 = static_cast<float>(currEdge1) * invTriangleArea;
+						float weight2 = static_cast<float>(currEdge2) * invTriangleArea;
+
+						// Calculate the Z depth at this pixel
+						const float interpolatedZDepth
+						{
+							1.0f /
+								(weight0 / depthZV0 +
+								weight1 / depthZV1 +
+								weight2 / depthZV2)
+						};
+
+						int pixelIdx = px + (py * m_Width);
+						if (m_pDepthBufferPixels[pixelIdx] < interpolatedZDepth)
+							continue;
+
+						m_pDepthBufferPixels[pixelIdx] = interpolatedZDepth;
+						isDepthWritten = true;
+						++depthPassedFragments;
+
+						if constexpr (WRITE_TRIANGLE_ID)
+						{
+							m_pTriangleIdBufferPixels[pixelIdx] = triangleIdx;
+						}
+						else if constexpr (RENDER_MODE == RenderMode::Texture)
+						{
+							// Calculate the W depth at this pixel
+							const float interpolatedWDepth
+							{
+								1.0f /
+									(weight0 / v0.position.w +
+									weight1 / v1.position.w +
+									weight2 / v2.position.w)
+							};
+
+							ShadePixel<RENDER_MODE, COLOR_MODE, USE_NORMALS>(px, py, edges, v0, v1, v2, weight0, weight1, weight2, interpolatedZDepth, interpolatedWDepth);
+						}
+						else
+						{
+							ShadePixel<RENDER_MODE, COLOR_MODE, USE_NORMALS>(px, py, edges, v0, v1, v2, weight0, weight1, weight2, interpolatedZDepth, 0.f);
+						}
+					}
+				}
+
+				if (m_UseHiZ && isDepthWritten)
+					blockMaxDepth = GetBlockMaxDepth(blockX, blockY);
+			}
+		}
+
+		m_FrameStats.rejectedBlocks.fetch_add(rejectedBlocks, std::memory_order_relaxed);
+		m_FrameStats.acceptedBlocks.fetch_add(acceptedBlocks, std::memory_order_relaxed);
+		m_FrameStats.partialBlocks.fetch_add(partialBlocks, std::memory_order_relaxed);
+		m_FrameStats.depthPassedFragments.fetch_add(depthPassedFragments, std::memory_order_relaxed);
+		if constexpr (!WRITE_TRIANGLE_ID)
+			m_FrameStats.shadedFragments.fetch_add(depthPassedFragments, std::memory_order_relaxed);
+	}
+
+	template<RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+	void SoftwareBackend::ResolveVisibilityBuffer(std::span<const Int2> screenVertices,
+		std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax)
+	{
+		uint64_t shadedFragments{};
+
+		for (int py{ clipMin.y }; py < clipMax.y; ++py)
+		{
+			for (int px{ clipMin.x }; px < clipMax.x; ++px)
+			{
+				const int pixelIdx{ px + (py * m_Width) };
+				const uint32_t triangleIdx{ m_pTriangleIdBufferPixels[pixelIdx] };
+				if (triangleIdx == INVALID_TRIANGLE_ID)
+					continue;
+
+				const RasterTriangle& triangle{ m_RasterTriangles[triangleIdx] };
+				const Vertex_Out& v0{ vertices_out[indices[triangle.idx0]] };
+				const Vertex_Out& v1{ vertices_out[indices[triangle.idx1]] };
+				const Vertex_Out& v2{ vertices_out[indices[triangle.idx2]] };
+
+				//The depth view only reads the stored depth
+				if constexpr (RENDER_MODE == RenderMode::DepthBuffer)
+				{
+					ShadePixel<RENDER_MODE, COLOR_MODE, USE_NORMALS>(px, py, EdgeEquations{}, v0, v1, v2, 0.f, 0.f, 0.f, m_pDepthBufferPixels[pixelIdx], 0.f);
+					++shadedFragments;
+					continue;
+				}
+
+				//Reconstruct the barycentrics from the same integer edges the depth pass evaluated
+				const EdgeEquations edges{ SetupEdgeEquations(screenVertices[indices[triangle.idx0]], screenVertices[indices[triangle.idx1]], screenVertices[indices[triangle.idx2]]) };
+				const float invTriangleArea{ 1.f / static_cast<float>(edges.doubleArea) };
+
+				const float weight0{ static_cast<float>(edges.Evaluate(0, px, py)) * invTriangleArea };
+				const float weight1{ static_cast<float>(edges.Evaluate(1, px, py)) * invTriangleArea };
+				const float weight2{ static_cast<float>(edges.Evaluate(2, px, py)) * invTriangleArea };
+
+				const float interpolatedWDepth
+				{
+					1.0f /
+						(weight0 / v0.position.w +
+						weight1 / v1.position.w +
+						weight2 / v2.position.w)
+				};
+
+				ShadePixel<RENDER_MODE, COLOR_MODE, USE_NORMALS>(px, py, edges, v0, v1, v2, weight0, weight1, weight2, m_pDepthBufferPixels[pixelIdx], interpolatedWDepth);
+				++shadedFragments;
+			}
+		}
+
+		m_FrameStats.shadedFragments.fetch_add(shadedFragments, std::memory_order_relaxed);
+	}
+
+	float SoftwareBackend::GetBlockMaxDepth(int blockX, int blockY) const
+	{
+		const int blockStartX{ blockX * HIZ_BLOCK_SIZE };
+		const int blockStartY{ blockY * HIZ_BLOCK_SIZE };
+		const int blockEndX{ std::min(blockStartX + HIZ_BLOCK_SIZE, m_Width) };
+		const int blockEndY{ std::min(blockStartY + HIZ_BLOCK_SIZE, m_Height) };
+
+		float maxDepth{ 0.f };
+		for (int py{ blockStartY }; py < blockEndY; ++py)
+		{
+			const float* pDepthRow{ m_pDepthBufferPixels + (py * m_Width) };
+			for (int px{ blockStartX }; px < blockEndX; ++px)
+				maxDepth = std::max(maxDepth, pDepthRow[px]);
+		}
+		return maxDepth;
+	}
+
+	UvDerivatives SoftwareBackend::ComputeQuadUvDerivatives(int px, int py, const EdgeEquations& edges, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2)
+	{
+		//Like a GPU quad: all four pixels of the 2x2 quad share the differences taken at its first pixel.
+		//The UVs are perspective correct, and the area cancels out so the raw edge values serve as weights
+		const auto uvAt{ [&](int x, int y)
+			{
+				const float weight0{ static_cast<float>(edges.Evaluate(0, x, y)) / v0.position.w };
+				const float weight1{ static_cast<float>(edges.Evaluate(1, x, y)) / v1.position.w };
+				const float weight2{ static_cast<float>(edges.Evaluate(2, x, y)) / v2.position.w };
+				return (weight0 * v0.uv + weight1 * v1.uv + weight2 * v2.uv) / (weight0 + weight1 + weight2);
+			} };
+
+		const int quadX{ px & ~1 };
+		const int quadY{ py & ~1 };
+		const Vector2 quadUv{ uvAt(quadX, quadY) };
+		return UvDerivatives{ uvAt(quadX + 1, quadY) - quadUv, uvAt(quadX, quadY + 1) - quadUv };
+	}
+
+	template<RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+	void SoftwareBackend::ShadePixel(int px, int py, const EdgeEquations& edges, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2,
+		float weight0, float weight1, float weight2, float interpolatedZDepth, float interpolatedWDepth)
+	{
+		const int pixelIdx{ px + (py * m_Width) };
+		if constexpr (RENDER_MODE == RenderMode::Texture)
+		{
+			//Only interpolate what PixelShading reads in this mode
+			constexpr bool NEEDS_UV{ USE_NORMALS || COLOR_MODE != ColorMode::observedArea };
+			constexpr bool NEEDS_TANGENT{ USE_NORMALS };
+			constexpr bool NEEDS_VIEW_DIRECTION{ COLOR_MODE == ColorMode::Specular || COLOR_MODE == ColorMode::Combined };
+
+			//W Depth
+			const float depthWV0{ v0.position.w };
+			const float depthWV1{ v1.position.w };
+			const float depthWV2{ v2.position.w };
+
+			Vertex_Out interpolatedVertex{};
+			UvDerivatives uvDerivatives{};
+
+			//UV interpolate
+			if constexpr (NEEDS_UV)
+			{
+				uvDerivatives = ComputeQuadUvDerivatives(px, py, edges, v0, v1, v2);
+
+				Vector2 uvInterpolate1{ weight0 * (v0.uv / depthWV0) };
+				Vector2 uvInterpolate2{ weight1 * (v1.uv / depthWV1) };
+				Vector2 uvInterpolate3{ weight2 * (v2.uv / depthWV2) };
+
+				Vector2 uvInterpolateTotal{ uvInterpolate1 + uvInterpolate2 + uvInterpolate3 };
+
+				Vector2 uvInterpolated{ interpolatedWDepth * uvInterpolateTotal };
+
+				interpolatedVertex.uv = uvInterpolated;
+			}
+
+			//Normal interpolate
+			Vector3 normalInterpolate1{ weight0 * (v0.normal / depthWV0) };
+			Vector3 normalInterpolate2{ weight1 * (v1.normal / depthWV1) };
+			Vector3 normalInterpolate3{ weight2 * (v2.normal / depthWV2) };
+
+			Vector3 normalInterpolateTotal{ normalInterpolate1 + normalInterpolate2 + normalInterpolate3 };
+			Vector3 normalInterpolated{ interpolatedWDepth * normalInterpolateTotal };
+
+			interpolatedVertex.normal = normalInterpolated.Normalized();
+
+			//Tangent interpolate
+			if constexpr (NEEDS_TANGENT)
+			{
+				Vector3 tangentInterpolate1{ weight0 * (v0.tangent / depthWV0) };
+				Vector3 tangentInterpolate2{ weight1 * (v1.tangent / depthWV1) };
+				Vector3 tangentInterpolate3{ weight2 * (v2.tangent / depthWV2) };
+
+				Vector3 tangentInterpolateTotal{ tangentInterpolate1 + tangentInterpolate2 + tangentInterpolate3 };
+				Vector3 tangentInterpolated{ interpolatedWDepth * tangentInterpolateTotal };
+
+				interpolatedVertex.tangent = tangentInterpolated.Normalized();
+			}
+
+			//viewdirection interpolate
+			if constexpr (NEEDS_VIEW_DIRECTION)
+			{
+				Vector3 viewDirectionInterpolate1{ weight0 * (v0.viewDirection / depthWV0) };
+				Vector3 viewDirectionInterpolate2{ weight1 * (v1.viewDirection / depthWV1) };
+				Vector3 viewDirectionInterpolate3{ weight2 * (v2.viewDirection / depthWV2) };
+
+				Vector3 viewDirectionInterpolateTotal{ viewDirectionInterpolate1 + viewDirectionInterpolate2 + viewDirectionInterpolate3 };
+				Vector3 viewDirectionInterpolated{ interpolatedWDepth * viewDirectionInterpolateTotal };
+
+				interpolatedVertex.viewDirection = viewDirectionInterpolated.Normalized();
+			}
+
+
+			//Kept as float, PackTile scales it down to one and converts it with the other pixels of the tile
+			const ColorRGB finalColor{ PixelShading<COLOR_MODE, USE_NORMALS>(interpolatedVertex, uvDerivatives) };
+			m_pRedBufferPixels[pixelIdx] = finalColor.r;
+			m_pGreenBufferPixels[pixelIdx] = finalColor.g;
+			m_pBlueBufferPixels[pixelIdx] = finalColor.b;
+		}
+		else
+		{
+			const float depthColor{ Utils::Remap(interpolatedZDepth, 0.985f, 1.f) };
+			m_pRedBufferPixels[pixelIdx] = depthColor;
+			m_pGreenBufferPixels[pixelIdx] = depthColor;
+			m_pBlueBufferPixels[pixelIdx] = depthColor;
+		}
+	}
+
+	template<ColorMode COLOR_MODE, bool USE_NORMALS>
+	ColorRGB SoftwareBackend::PixelShading(const Vertex_Out& vertex_out, const UvDerivatives& uvDerivatives)
+	{
+		Vector3 pixelNormal{ vertex_out.normal };
+		//Normal calculations
+		if constexpr (USE_NORMALS)
+		{
+			Vector3 binormal = Vector3::Cross(vertex_out.normal, vertex_out.tangent);
+			Matrix tangentSpaceAxis = Matrix{ vertex_out.tangent, binormal, vertex_out.normal, Vector3::Zero };
+			auto sampledNormal{ m_Material.pNormal->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout) };
+
+			sampledNormal = (2.f * sampledNormal) - ColorRGB{ 1.f, 1.f, 1.f }; // [0, 1] -> [-1, 1]
+
+			Vector3 sampledNormalVector{ sampledNormal.r, sampledNormal.g, sampledNormal.b };
+			pixelNormal = tangentSpaceAxis.TransformVector(sampledNormalVector);
+		}
+
+		Vector3 lightDirection = Vector3{ .577f, -.577f , .577f }.Normalized();
+		float lightIntensity{ 7.f };
+		float glossiness{ 25.f };
+		ColorRGB ambient{ .025f, .025f, .025f };
+		float observedArea = std::max(Vector3::Dot(-lightDirection, pixelNormal), 0.f);
+
+		//A term whose map the material does not have is left out
+		const bool hasDiffuse{ m_Material.pDiffuse != nullptr };
+		const bool hasSpecular{ m_Material.pGlossiness != nullptr && m_Material.pSpecular != nullptr };
+
+		if constexpr (COLOR_MODE == ColorMode::observedArea)
+		{
+			return ColorRGB{ observedArea, observedArea, observedArea };
+		}
+		else if constexpr (COLOR_MODE == ColorMode::Diffuse)
+		{
+			if (!hasDiffuse)
+				return ColorRGB{};
+
+			ColorRGB finalColor{ Lambert(lightIntensity, m_Material.pDiffuse->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout)) };
+			return finalColor * observedArea;
+		}
+		else if constexpr (COLOR_MODE == ColorMode::Specular)
+		{
+			if (!hasSpecular)
+				return ColorRGB{};
+
+			float exponent{ m_Material.pGlossiness->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout).r * glossiness };
+			return Phong(1.0f, exponent, -lightDirection, vertex_out.viewDirection, pixelNormal) * m_Material.pSpecular->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout);
+		}
+		else
+		{
+			ColorRGB lambert{};
+			if (hasDiffuse)
+				lambert = 1.0f * m_Material.pDiffuse->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout) / PI;
+
+			ColorRGB specular{};
+			if (hasSpecular)
+			{
+				const float phongExponent{ m_Material.pGlossiness->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout).r * glossiness };
+				specular = m_Material.pSpecular->Sample(vertex_out.uv, uvDerivatives, m_TextureFilter, m_TexelLayout) * Phong(1.0f, phongExponent, -lightDirection, vertex_out.viewDirection, pixelNormal);
+			}
+
+			return (lightIntensity * lambert + specular) * observedArea + ambient;
+		}
+	}
+
+	ColorRGB SoftwareBackend::Lambert(float kd, const ColorRGB& cd)
+	{
+		return (kd * cd) / static_cast<float>(M_PI);
+	}
+
+	ColorRGB SoftwareBackend::Phong(float ks, float exp, const Vector3& l, const Vector3& v, const Vector3& n)
+	{
+
+		Vector3 reflect{ Vector3::Reflect(l,n) };
+		float angle = std::max(Vector3::Dot(reflect, v), 0.f);
+
+		float specularReflection = ks * powf(angle, exp);
+
+		return ColorRGB{ specularReflection, specularReflection, specularReflection };
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include "Math.h"
+#include "RenderBackend.h"
+#include "FrameTarget.h"
+#include "Texture.h"
+#include "DataTypes.h"
+#include "ThreadPool.h"
+#include "RasterKernels.h"
+#include "VertexStage.h"
+#include "FrameStats.h"
+#include "FrameArena.h"
+#include "PixelPacking.h"
+
+//Standard includes
+#include <span>
+#include <vector>
+
+namespace dae
+{
+	//The CPU rasterizer: clip, set up and bin triangles, then rasterize and shade them per screen tile on a thread pool.
+	//Only needs the standard library, it builds on its own as the SoftwareRasterizer library (see CMakeLists.txt)
+	class SoftwareBackend final : public RenderBackend
+	{
+	public:
+		//Frames go to pFrameTarget, which has to be width x height and outlive the backend
+		SoftwareBackend(int width, int height, FrameTarget* pFrameTarget);
+		~SoftwareBackend() override;
+
+		SoftwareBackend(const SoftwareBackend&) = delete;
+		SoftwareBackend(SoftwareBackend&&) noexcept = delete;
+		SoftwareBackend& operator=(const SoftwareBackend&) = delete;
+		SoftwareBackend& operator=(SoftwareBackend&&) noexcept = delete;
+
+		void Render(const Scene& scene) override;
+
+		void SwitchRenderMode();
+		void SwitchColorMode();
+		void ToggleNormals();
+		void ToggleBoundingBoxVisualisation();
+		void ToggleTiledRendering();
+		void ToggleSimdKernel();
+		void SwitchTextureFilter();
+		void ToggleTexelLayout();
+		void ToggleHiZ();
+		void ToggleVisibilityBuffer();
+
+		void PrintFrameStats() const;
+		//Pixels of the last frame, nullptr before the first one. Stay valid until the target hands them out again
+		const uint32_t* GetFramePixels() const { return m_pBackBufferPixels; }
+		int GetWidth() const { return m_Width; }
+		int GetHeight() const { return m_Height; }
+		//What the benchmarks of the application run on: the clip space vertices of the last frame, and the kernels and threads the backend uses
+		std::span<const Vertex_Out> GetTransformedVertices() const { return m_TransformedVertices; }
+		RasterKernels::KernelType GetKernelType() const { return m_KernelType; }
+		TexelLayout GetTexelLayout() const { return m_TexelLayout; }
+		ThreadPool& GetThreadPool() const { return *m_pThreadPool; }
+		//Screen space triangles of the last frame, the vertices and indices stay valid until the next Render
+		std::span<const RasterTriangle> GetRasterTriangles() const { return m_RasterTriangles; }
+		std::span<const Int2> GetRasterVertices() const { return m_RasterVertices; }
+		std::span<const uint32_t> GetRasterIndices() const { return m_RasterIndices; }
+
+		//RenderTriangle walks every triangle in blocks of HIZ_BLOCK_SIZE^2 pixels, stepping the edges of SetupEdgeEquations.
+		//Public for Benchmark::EdgeStepping, which runs the same scan
+		static constexpr int HIZ_BLOCK_SIZE{ 8 };
+		static EdgeEquations SetupEdgeEquations(const Int2& p0, const Int2& p1, const Int2& p2);
+
+	private:
+		int m_Width{};
+		int m_Height{};
+
+		bool m_UseNormals{ true };
+		bool m_ShowBoundingBox{ false };
+		bool m_UseTiledRendering{ true };
+		bool m_UseSimdKernel{ true };
+		TextureFilter m_TextureFilter{ TextureFilter::Point };
+		TexelLayout m_TexelLayout{ TexelLayout::Tiled };
+		bool m_UseHiZ{ true };
+		bool m_UseVisibilityBuffer{ false };
+
+		//Modes
+		RenderMode m_CurrentRenderMode{ RenderMode::Texture };
+		ColorMode m_CurrentColorMode{ ColorMode::observedArea };
+		//Copied from the scene at the start of every frame
+		CullFaceMode m_CurrentCullMode{ CullFaceMode::None };
+		Material m_Material{};
+
+		FrameTarget* m_pFrameTarget;
+		//Pixels of the current frame, set by AcquireBackBuffer
+		uint32_t* m_pBackBufferPixels{};
+		float* m_pDepthBufferPixels{};
+		//Shaded colors before packing, one plane per channel so the pack kernel loads eight pixels per instruction
+		float* m_pRedBufferPixels{};
+		float* m_pGreenBufferPixels{};
+		float* m_pBlueBufferPixels{};
+		PixelPacking::PackFunction m_pPackPixels{ nullptr };
+
+		//HiZ: farthest depth of every HIZ_BLOCK_SIZE block of m_pDepthBufferPixels
+		int m_NumHiZBlocksX{};
+		int m_NumHiZBlocksY{};
+		float* m_pHiZBufferPixels{};
+
+		//Visibility buffer: index into m_RasterTriangles of the closest triangle per pixel
+		static constexpr uint32_t INVALID_TRIANGLE_ID{ UINT32_MAX };
+		uint32_t* m_pTriangleIdBufferPixels{};
+
+		FrameStats m_FrameStats{};
+
+		//Sort-middle tiling: triangles are binned per screen tile, every tile is rasterized by one thread
+		static constexpr int TILE_SIZE{ 64 };
+		static_assert(TILE_SIZE % HIZ_BLOCK_SIZE == 0, "HiZ blocks may not straddle tiles, each tile is owned by one thread");
+		int m_NumTilesX{};
+		int m_NumTilesY{};
+		ThreadPool* m_pThreadPool{ nullptr };
+		std::vector<RasterTriangle> m_RasterTriangles{};
+		//What m_RasterTriangles index, in the frame arena
+		std::span<const Int2> m_RasterVertices{};
+		std::span<const uint32_t> m_RasterIndices{};
+		//Triangle indices of tile i are m_TileBinTriangles[m_TileBinOffsets[i], m_TileBinOffsets[i + 1]), both live in the frame arena
+		std::span<uint32_t> m_TileBinOffsets{};
+		std::span<uint32_t> m_TileBinTriangles{};
+		//Lazy clear: set for every tile at the start of a frame, the tile's depth, HiZ, triangle id and color are only
+		//cleared once a triangle touches it. Tiles still set when packing get the packed clear color directly.
+		//One byte per tile, each is only written by the thread that owns the tile
+		std::vector<uint8_t> m_IsTileClearPending{};
+		float m_ClearColor{};
+
+		//Clip space output of the vertex stage, same size every frame so it only allocates the first time
+		std::vector<Vertex_Out> m_TransformedVertices{};
+
+		//Output of the clipper for this frame, already perspective divided
+		std::vector<Vertex_Out> m_ClippedVertices{};
+		std::vector<Int2> m_ClippedScreenVertices{};
+		std::vector<uint32_t> m_ClippedIndices{};
+
+		//Projected vertices and the streams the rasterizer reads, rewound at the start of every frame
+		static constexpr size_t FRAME_ARENA_SIZE{ 4 * 1024 * 1024 };
+		FrameArena m_FrameArena{ FRAME_ARENA_SIZE };
+
+		//Coverage/depth kernel picked with CPUID, nullptr falls back to the scalar loop in RenderTriangle
+		RasterKernels::KernelType m_KernelType{ RasterKernels::KernelType::Scalar };
+		RasterKernels::SpanKernel m_pSpanKernel{ nullptr };
+		VertexStage::TransformFunction m_pTransformVertices{ nullptr };
+
+		void VertexTransformationFunction(const Mesh& mesh, const Matrix& worldViewProjectionMatrix); //W1 Version
+		Int2 ProjectVertex(Vertex_Out& vertex) const;
+		void SetupTriangle(int idx0, int idx1, int idx2, std::span<const Vertex_Out> clipVertices, std::span<const Int2> screenVertices, std::span<const uint32_t> indices);
+		void AddRasterTriangle(int idx0, int idx1, int idx2, const Int2& p0, const Int2& p1, const Int2& p2);
+		void BinTriangles();
+		Int2 GetTileMin(uint32_t tileIdx) const;
+		Int2 GetTileMax(uint32_t tileIdx) const;
+		void ResolveTileClear(uint32_t tileIdx);
+		void ResolveTileClears(const RasterTriangle& triangle);
+		void PackTile(uint32_t tileIdx);
+		void AcquireBackBuffer();
+		void PresentBackBuffer();
+
+		//Raster pipeline: one instantiation per render state combination, picked once per frame
+		using RenderTriangleFunction = void (SoftwareBackend::*)(uint32_t triangleIdx, std::span<const Int2> screenVertices, std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax);
+		using ResolveFunction = void (SoftwareBackend::*)(std::span<const Int2> screenVertices, std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax);
+		struct RasterPipeline
+		{
+			RenderTriangleFunction pRenderTriangle{ nullptr };
+			//Shading pass of the visibility buffer, nullptr when shading immediately
+			ResolveFunction pResolve{ nullptr };
+		};
+		RasterPipeline SelectRasterPipeline() const;
+		template<ColorMode COLOR_MODE> RasterPipeline SelectRasterPipeline() const;
+		template<RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS> RasterPipeline MakeRasterPipeline() const;
+
+		void RenderTile(uint32_t tileIdx, const RasterPipeline& pipeline, std::span<const Int2> screenVertices, std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices);
+		void RenderTriangleBoundingBox(uint32_t triangleIdx, std::span<const Int2> screenVertices, std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax);
+		template<bool WRITE_TRIANGLE_ID, RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+		void RenderTriangle(uint32_t triangleIdx, std::span<const Int2> screenVertices, std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax);
+		template<RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+		void ResolveVisibilityBuffer(std::span<const Int2> screenVertices, std::span<const Vertex_Out> vertices_out, std::span<const uint32_t> indices, const Int2& clipMin, const Int2& clipMax);
+		float GetBlockMaxDepth(int blockX, int blockY) const;
+		template<RenderMode RENDER_MODE, ColorMode COLOR_MODE, bool USE_NORMALS>
+		void ShadePixel(int px, int py, const EdgeEquations& edges, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2, float weight0, float weight1, float weight2, float interpolatedZDepth, float interpolatedWDepth);
+		static UvDerivatives ComputeQuadUvDerivatives(int px, int py, const EdgeEquations& edges, const Vertex_Out& v0, const Vertex_Out& v1, const Vertex_Out& v2);
+		template<ColorMode COLOR_MODE, bool USE_NORMALS>
+		ColorRGB PixelShading(const Vertex_Out& vertex_out, const UvDerivatives& uvDerivatives);
+		ColorRGB Lambert(float kd, const ColorRGB& cd);
+		ColorRGB Phong(float ks, float exp, const Vector3& l, const Vector3& v, const Vector3& n);
+	};
+}
@@ -0,0 +1,137 @@
+#include "pch.h"
+#include "Texture.h"
+
+//Standard includes
+#include <array>
+
+namespace dae
+{
+	const float* Texture::GetUnormTable()
+	{
+		static const std::array<float, 256> table{ []
+			{
+				std::array<float, 256> values{};
+				for (size_t i{}; i < values.size(); ++i)
+					values[i] = static_cast<float>(i) / 255.f;
+				return values;
+			}() };
+		return table.data();
+	}
+
+	size_t Texture::GetBaseLevelSize() const
+	{
+		const MipLevel& baseLevel{ m_MipLevels.front() };
+		return static_cast<size_t>(baseLevel.width) * baseLevel.height * sizeof(uint32_t);
+	}
+
+	size_t Texture::GetMipChainSize() const
+	{
+		return m_MipStorage.size() * sizeof(uint32_t);
+	}
+
+	size_t Texture::GetTiledMipChainSize() const
+	{
+		size_t texelCount{};
+		for (const MipLevel& level : m_TiledLevels)
+			texelCount += static_cast<size_t>(level.rowStride) * ((level.height + TILE_SIZE - 1) / TILE_SIZE);
+		return texelCount * sizeof(uint32_t);
+	}
+
+	const uint32_t* Texture::GetTexelAddress(size_t level, int x, int y, TexelLayout layout) const
+	{
+		if (layout == TexelLayout::Tiled)
+			return m_TiledLevels[level].pTexels + TiledAddressing::RowOffset(m_TiledLevels[level], y) + TiledAddressing::ColumnOffset(x);
+		return m_MipLevels[level].pTexels + LinearAddressing::RowOffset(m_MipLevels[level], y) + LinearAddressing::ColumnOffset(x);
+	}
+
+	void Texture::BuildMipChain(int width, int height, const uint32_t* pTexels, int rowStride)
+	{
+		//Sizes first, so the levels can point into storage that never reallocates
+		size_t storageSize{ static_cast<size_t>(width) * height };
+		for (int levelWidth{ width }, levelHeight{ height }; levelWidth > 1 || levelHeight > 1;)
+		{
+			levelWidth = std::max(levelWidth / 2, 1);
+			levelHeight = std::max(levelHeight / 2, 1);
+			storageSize += static_cast<size_t>(levelWidth) * levelHeight;
+		}
+		m_MipStorage.resize(storageSize);
+
+		uint32_t* pLevelTexels{ m_MipStorage.data() };
+		for (int y{}; y < height; ++y)
+			std::copy_n(pTexels + (static_cast<size_t>(y) * rowStride), width, pLevelTexels + (static_cast<size_t>(y) * width));
+		m_MipLevels.push_back(MipLevel{ pLevelTexels, width, height, width });
+		pLevelTexels += static_cast<size_t>(width) * height;
+
+		while (m_MipLevels.back().width > 1 || m_MipLevels.back().height > 1)
+		{
+			const MipLevel source{ m_MipLevels.back() };
+			const MipLevel level{ pLevelTexels, std::max(source.width / 2, 1), std::max(source.height / 2, 1), std::max(source.width / 2, 1) };
+
+			//2x2 box filter, the last row or column of an odd sized level is folded into its neighbour
+			for (int y{}; y < level.height; ++y)
+			{
+				for (int x{}; x < level.width; ++x)
+				{
+					uint32_t sum[4]{};
+					for (int sampleIdx{}; sampleIdx < 4; ++sampleIdx)
+					{
+						const int sourceX{ std::min(2 * x + (sampleIdx & 1), source.width - 1) };
+						const int sourceY{ std::min(2 * y + (sampleIdx >> 1), source.height - 1) };
+
+						const uint32_t texel{ source.pTexels[sourceX + (sourceY * source.rowStride)] };
+						for (int channel{}; channel < 4; ++channel)
+							sum[channel] += (texel >> (8 * channel)) & 0xFF;
+					}
+
+					uint32_t texel{};
+					for (int channel{}; channel < 4; ++channel)
+						texel |= ((sum[channel] + 2) / 4) << (8 * channel);
+					pLevelTexels[x + (y * level.rowStride)] = texel;
+				}
+			}
+
+			m_MipLevels.push_back(level);
+			pLevelTexels += static_cast<size_t>(level.width) * level.height;
+		}
+	}
+	int Texture::GetTilesPerRow(int width)
+	{
+		//One spare tile per row when there is more than one, otherwise with power of two sizes every tile
+		//of a column maps to the same cache set and sampling down a column evicts its own lines
+		const int tileCount{ (width + TILE_SIZE - 1) / TILE_SIZE };
+		return tileCount > 1 ? tileCount + 1 : tileCount;
+	}
+
+	void Texture::BuildTiledMipChain()
+	{
+		constexpr size_t cacheLineSize{ 64 };
+		constexpr size_t alignmentTexels{ cacheLineSize / sizeof(uint32_t) };
+		static_assert(TILE_TEXELS * sizeof(uint32_t) == cacheLineSize, "A tile has to fill one cache line");
+
+		//Every level is a whole number of tiles, so once the first one starts on a line all of them do
+		size_t storageSize{};
+		for (const MipLevel& level : m_MipLevels)
+			storageSize += static_cast<size_t>(GetTilesPerRow(level.width)) * ((level.height + TILE_SIZE - 1) / TILE_SIZE) * TILE_TEXELS;
+		m_TiledStorage.assign(storageSize + alignmentTexels - 1, 0);
+
+		const size_t misalignment{ reinterpret_cast<uintptr_t>(m_TiledStorage.data()) / sizeof(uint32_t) % alignmentTexels };
+		uint32_t* pLevelTexels{ m_TiledStorage.data() + (misalignment ? alignmentTexels - misalignment : 0) };
+
+		for (const MipLevel& source : m_MipLevels)
+		{
+			const int tilesPerRow{ GetTilesPerRow(source.width) };
+			const int tileRows{ (source.height + TILE_SIZE - 1) / TILE_SIZE };
+			const MipLevel level{ pLevelTexels, source.width, source.height, tilesPerRow * TILE_TEXELS };
+
+			//Texels past the edge of a level that is not a multiple of the tile size stay zero, sampling never reads them
+			for (int y{}; y < source.height; ++y)
+			{
+				for (int x{}; x < source.width; ++x)
+					pLevelTexels[TiledAddressing::RowOffset(level, y) + TiledAddressing::ColumnOffset(x)] = source.pTexels[LinearAddressing::RowOffset(source, y) + x];
+			}
+
+			m_TiledLevels.push_back(level);
+			pLevelTexels += static_cast<size_t>(tilesPerRow) * tileRows * TILE_TEXELS;
+		}
+	}
+}
@@ -4,111 +4,219 @@
 
 namespace dae
 {
+	//Software sampling modes, the counterparts of the samPoint/samLinear techniques of the hardware path
+	enum class TextureFilter
+	{
+		Point, //Nearest texel of the nearest mip level
+		Bilinear, //2x2 texels of the nearest mip level
+		Trilinear, //2x2 texels of the two closest mip levels
+
+		END
+	};
+
+	//Order of the texels of a mip level in memory, for the software sampler. The GPU always gets the linear chain
+	enum class TexelLayout
+	{
+		Linear, //Row major, the order the texture was loaded in
+		Tiled, //4x4 texel tiles of one 64 byte cache line each, tiles in row major order
+
+		END
+	};
+
+	//UV change per pixel step along screen x and y, taken over a 2x2 pixel quad like the GPU does
+	struct UvDerivatives
+	{
+		Vector2 dx{};
+		Vector2 dy{};
+	};
+
+	//CPU side of a texture: the RGBA8 mip chain in a linear and a tiled layout, and the software sampler.
+	//The hardware backend uploads the linear chain into a HardwareTexture of its own
 	class Texture
 	{
 	public:
-		Texture(SDL_Surface* pSurface):
-			m_pSurface{pSurface},
-			m_pSurfacePixels{ (uint32_t*)pSurface->pixels }
+		//Copies width x height RGBA8 texels (R in the lowest byte), rowStride texels apart, and builds the mip chains
+		Texture(int width, int height, const uint32_t* pTexels, int rowStride)
 		{
+			BuildMipChain(width, height, pTexels, rowStride);
+			BuildTiledMipChain();
 		}
 
-		~Texture()
-		{
-			if (m_pSurface)
-			{
-				SDL_FreeSurface(m_pSurface);
-				m_pSurface = nullptr;
-
-				if (m_pSRV != nullptr)
-				{
-					m_pSRV->Release();
-					m_pSRV = nullptr;
-				}
-
-				if (m_pResource != nullptr)
-				{
-					m_pResource->Release();
-					m_pResource = nullptr;
-				}
+		//The levels point into the storage vectors
+		Texture(const Texture&) = delete;
+		Texture(Texture&&) noexcept = delete;
+		Texture& operator=(const Texture&) = delete;
+		Texture& operator=(Texture&&) noexcept = delete;
 
-			}
+		//One texel of the given color, stands in for a texture that is still loading
+		static Texture* CreateSolidColor(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+		{
+			const uint32_t texel{ r | (static_cast<uint32_t>(g) << 8) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(a) << 24) };
+			return new Texture{ 1, 1, &texel, 1 };
 		}
 
-		static Texture* LoadFromFile(const std::string& path, ID3D11Device* pDevice)
+		//Every level holds packed RGBA8 texels (R in the lowest byte, the DXGI_FORMAT_R8G8B8A8_UNORM layout)
+		struct MipLevel
 		{
-			SDL_Surface* loadSurface = IMG_Load(path.c_str());
-
-			Texture* returnTexture{ new Texture{ loadSurface } };
+			const uint32_t* pTexels{ nullptr };
+			int width{};
+			int height{};
+			//Texels from one row to the next when linear, from one row of tiles to the next when tiled
+			int rowStride{};
+		};
+
+		//Wrap addressing like the hardware samplers, the mip level follows from the derivatives.
+		//Both layouts hold the same texels, so they return the same color
+		ColorRGB Sample(const Vector2& uv, const UvDerivatives& derivatives, TextureFilter filter, TexelLayout layout) const
+		{
+			if (layout == TexelLayout::Tiled)
+				return SampleMipChain<TiledAddressing>(m_TiledLevels, uv, derivatives, filter);
+			return SampleMipChain<LinearAddressing>(m_MipLevels, uv, derivatives, filter);
+		}
 
-			DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
-			D3D11_TEXTURE2D_DESC desc{};
-			desc.Width = loadSurface->w;
-			desc.Height = loadSurface->h;
-			desc.MipLevels = 1;
-			desc.ArraySize = 1;
-			desc.Format = format;
-			desc.SampleDesc.Count = 1;
-			desc.SampleDesc.Quality = 0;
-			desc.Usage = D3D11_USAGE_DEFAULT;
-			desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-			desc.CPUAccessFlags = 0;
-			desc.MiscFlags = 0;
+		int GetWidth() const { return m_MipLevels.front().width; }
+		int GetHeight() const { return m_MipLevels.front().height; }
+		size_t GetNumMipLevels() const { return m_MipLevels.size(); }
+		//Bytes of texel data in the base level, and in the whole chain including the base level
+		size_t GetBaseLevelSize() const;
+		size_t GetMipChainSize() const;
+		//Bytes of the tiled copy of the chain, levels are padded to whole tiles
+		size_t GetTiledMipChainSize() const;
 
+		//Address of texel (x, y) of a level in the given layout, to see which cache lines a sample touches
+		const uint32_t* GetTexelAddress(size_t level, int x, int y, TexelLayout layout) const;
 
-			D3D11_SUBRESOURCE_DATA initData;
-			initData.pSysMem = loadSurface->pixels;
-			initData.SysMemPitch = static_cast<UINT>(loadSurface->pitch);
-			initData.SysMemSlicePitch = static_cast<UINT>(loadSurface->pitch * loadSurface->h);
+		//Level of the linear chain, for uploading it
+		const MipLevel& GetMipLevel(size_t level) const { return m_MipLevels[level]; }
 
-			HRESULT result = pDevice->CreateTexture2D(&desc, &initData, &returnTexture->m_pResource);
+	private:
+		std::vector<MipLevel> m_MipLevels{};
+		std::vector<uint32_t> m_MipStorage{};
+		std::vector<MipLevel> m_TiledLevels{};
+		std::vector<uint32_t> m_TiledStorage{};
+
+		//Texel coordinates are never negative here, so tiles are found with shifts and masks
+		static constexpr int TILE_SHIFT{ 2 };
+		static constexpr int TILE_SIZE{ 1 << TILE_SHIFT };
+		static constexpr int TILE_TEXELS{ TILE_SIZE * TILE_SIZE };
+
+		//Offsets are split per axis, a bilinear footprint then costs two of each instead of four full addresses
+		struct LinearAddressing
+		{
+			static size_t RowOffset(const MipLevel& level, int y)
+			{
+				return static_cast<size_t>(y) * level.rowStride;
+			}
 
-			if (FAILED(result))
+			static size_t ColumnOffset(int x)
 			{
-				delete returnTexture;
-				return nullptr;
+				return static_cast<size_t>(x);
 			}
+		};
 
-			D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
-			SRVDesc.Format = format;
-			SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-			SRVDesc.Texture2D.MipLevels = 1;
+		struct TiledAddressing
+		{
+			static size_t RowOffset(const MipLevel& level, int y)
+			{
+				return (static_cast<size_t>(y >> TILE_SHIFT) * level.rowStride) + ((y & (TILE_SIZE - 1)) << TILE_SHIFT);
+			}
 
-			result = pDevice->CreateShaderResourceView(returnTexture->m_pResource, &SRVDesc, &returnTexture->m_pSRV);
-			if (FAILED(result))
+			static size_t ColumnOffset(int x)
 			{
-				delete returnTexture;
-				return nullptr;
+				return (static_cast<size_t>(x >> TILE_SHIFT) * TILE_TEXELS) + (x & (TILE_SIZE - 1));
 			}
+		};
+
+		//log2 of the texels covered by one pixel step, <= 0 when magnified
+		static float ComputeLod(const MipLevel& baseLevel, const UvDerivatives& derivatives)
+		{
+			const float width{ static_cast<float>(baseLevel.width) };
+			const float height{ static_cast<float>(baseLevel.height) };
+
+			const Vector2 texelsX{ derivatives.dx.x * width, derivatives.dx.y * height };
+			const Vector2 texelsY{ derivatives.dy.x * width, derivatives.dy.y * height };
+			return 0.5f * std::log2(std::max(texelsX.SqrMagnitude(), texelsY.SqrMagnitude()));
+		}
+
+		//Level 0 is copied into m_MipStorage as well, with the levels packed behind it
+		void BuildMipChain(int width, int height, const uint32_t* pTexels, int rowStride);
+		//Copies the linear chain into m_TiledStorage, starting on a cache line so every tile is exactly one line
+		void BuildTiledMipChain();
+		static int GetTilesPerRow(int width);
+
+		//Decoded channel values, r / 255.f without the divide
+		static const float* GetUnormTable();
+
+		static float WrapCoordinate(float coordinate)
+		{
+			return coordinate - std::floor(coordinate);
+		}
 
-			return returnTexture;
+		static int WrapTexel(int texel, int size)
+		{
+			texel %= size;
+			return texel < 0 ? texel + size : texel;
 		}
-		ColorRGB Sample(const Vector2& uv) const
+
+		template<typename Addressing>
+		static ColorRGB SampleMipChain(const std::vector<MipLevel>& levels, const Vector2& uv, const UvDerivatives& derivatives, TextureFilter filter)
 		{
-			//TODO
-			//Sample the correct texel for the given uv
-			Uint32 x{ Uint32(uv.x * m_pSurface->w) }, y{ Uint32(uv.y * m_pSurface->h) };
+			const float lod{ ComputeLod(levels.front(), derivatives) };
+			const int maxLevel{ static_cast<int>(levels.size()) - 1 };
+
+			//Written as !(lod > x) so a NaN lod of a degenerate quad ends up on the base level
+			if (filter == TextureFilter::Trilinear)
+			{
+				if (!(lod > 0.f))
+					return SampleBilinear<Addressing>(levels.front(), uv);
+				if (lod >= static_cast<float>(maxLevel))
+					return SampleBilinear<Addressing>(levels.back(), uv);
 
-			//std::cout << "x: " << uv.x << " y: " << uv.y << "\n";
+				const int level{ static_cast<int>(lod) };
+				return ColorRGB::Lerp(SampleBilinear<Addressing>(levels[level], uv), SampleBilinear<Addressing>(levels[level + 1], uv), lod - static_cast<float>(level));
+			}
 
-			uint8_t r, g, b;
+			const int level{ !(lod > 0.f) ? 0 : std::min(static_cast<int>(lod + 0.5f), maxLevel) };
+			if (filter == TextureFilter::Bilinear)
+				return SampleBilinear<Addressing>(levels[level], uv);
+			return SamplePoint<Addressing>(levels[level], uv);
+		}
 
-			SDL_GetRGB(m_pSurfacePixels[static_cast<uint32_t>(x + (y * m_pSurface->w))],
-				m_pSurface->format,
-				&r,
-				&g,
-				&b);
+		static ColorRGB DecodeTexel(uint32_t texel)
+		{
+			static const float* pUnorm{ GetUnormTable() };
+			return ColorRGB{ pUnorm[texel & 0xFF], pUnorm[(texel >> 8) & 0xFF], pUnorm[(texel >> 16) & 0xFF] };
+		}
 
-			ColorRGB pixelColor{ r / 255.f, g / 255.f, b / 255.f };
-			return pixelColor;
+		template<typename Addressing>
+		static ColorRGB SamplePoint(const MipLevel& level, const Vector2& uv)
+		{
+			const int x{ std::min(static_cast<int>(WrapCoordinate(uv.x) * level.width), level.width - 1) };
+			const int y{ std::min(static_cast<int>(WrapCoordinate(uv.y) * level.height), level.height - 1) };
+			return DecodeTexel(level.pTexels[Addressing::RowOffset(level, y) + Addressing::ColumnOffset(x)]);
 		}
-		ID3D11ShaderResourceView* GetSRV() { return m_pSRV; }
 
-	private:
-		ID3D11ShaderResourceView* m_pSRV{nullptr}; //If something breaks maybe it was this?
-		ID3D11Texture2D* m_pResource{nullptr}; //If something breaks maybe it was this?
-		
-		SDL_Surface* m_pSurface{ nullptr };
-		uint32_t* m_pSurfacePixels{ nullptr };
+		template<typename Addressing>
+		static ColorRGB SampleBilinear(const MipLevel& level, const Vector2& uv)
+		{
+			//Texel centers sit at half coordinates
+			const float texelX{ WrapCoordinate(uv.x) * level.width - 0.5f };
+			const float texelY{ WrapCoordinate(uv.y) * level.height - 0.5f };
+			const float floorX{ std::floor(texelX) };
+			const float floorY{ std::floor(texelY) };
+			const float fractionX{ texelX - floorX };
+			const float fractionY{ texelY - floorY };
+
+			const int x0{ WrapTexel(static_cast<int>(floorX), level.width) };
+			const int y0{ WrapTexel(static_cast<int>(floorY), level.height) };
+			const size_t column0{ Addressing::ColumnOffset(x0) };
+			const size_t column1{ Addressing::ColumnOffset(WrapTexel(x0 + 1, level.width)) };
+			const uint32_t* pRow0{ level.pTexels + Addressing::RowOffset(level, y0) };
+			const uint32_t* pRow1{ level.pTexels + Addressing::RowOffset(level, WrapTexel(y0 + 1, level.height)) };
+
+			const ColorRGB top{ ColorRGB::Lerp(DecodeTexel(pRow0[column0]), DecodeTexel(pRow0[column1]), fractionX) };
+			const ColorRGB bottom{ ColorRGB::Lerp(DecodeTexel(pRow1[column0]), DecodeTexel(pRow1[column1]), fractionX) };
+			return ColorRGB::Lerp(top, bottom, fractionY);
+		}
 	};
 }
\ No newline at end of file
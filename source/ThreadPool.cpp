@@ -0,0 +1,84 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+	ThreadPool::ThreadPool(uint32_t numWorkers)
+	{
+		m_Workers.reserve(numWorkers);
+		for (uint32_t i = 0; i < numWorkers; ++i)
+			m_Workers.emplace_back(&ThreadPool::WorkerLoop, this);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_IsStopping = true;
+		}
+		m_WakeCondition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	void ThreadPool::RunParallel(uint32_t jobCount, JobFunction pJobFunction, const void* pJob)
+	{
+		if (jobCount == 0)
+			return;
+
+		{
+			std::lock_guard lock{ m_Mutex };
+			m_pJobFunction = pJobFunction;
+			m_pJob = pJob;
+			m_JobCount = jobCount;
+			m_NextJob.store(0, std::memory_order_relaxed);
+			m_BusyWorkers = static_cast<uint32_t>(m_Workers.size());
+			++m_Generation;
+		}
+		m_WakeCondition.notify_all();
+
+		//The calling thread helps out instead of idling
+		RunJobs();
+
+		std::unique_lock lock{ m_Mutex };
+		m_DoneCondition.wait(lock, [this] { return m_BusyWorkers == 0; });
+		m_pJobFunction = nullptr;
+		m_pJob = nullptr;
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		uint64_t seenGeneration{};
+		while (true)
+		{
+			{
+				std::unique_lock lock{ m_Mutex };
+				m_WakeCondition.wait(lock, [&] { return m_IsStopping || m_Generation != seenGeneration; });
+
+				if (m_IsStopping)
+					return;
+
+				seenGeneration = m_Generation;
+			}
+
+			RunJobs();
+
+			{
+				std::lock_guard lock{ m_Mutex };
+				--m_BusyWorkers;
+			}
+			m_DoneCondition.notify_one();
+		}
+	}
+
+	void ThreadPool::RunJobs()
+	{
+		uint32_t jobIdx{ m_NextJob.fetch_add(1, std::memory_order_relaxed) };
+		while (jobIdx < m_JobCount)
+		{
+			m_pJobFunction(m_pJob, jobIdx);
+			jobIdx = m_NextJob.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+}
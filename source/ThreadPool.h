@@ -0,0 +1,57 @@
+#pragma once
+
+//Standard includes
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+
+namespace dae
+{
+	class ThreadPool final
+	{
+	public:
+		//numWorkers excludes the calling thread, which also picks up jobs in ParallelFor
+		explicit ThreadPool(uint32_t numWorkers);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool(ThreadPool&&) noexcept = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+		//Runs job(0) ... job(jobCount - 1) spread over all threads, returns once every job has finished.
+		//The job is only referenced, never wrapped in a std::function, so this does not allocate
+		template<typename Job>
+		void ParallelFor(uint32_t jobCount, const Job& job)
+		{
+			RunParallel(jobCount, [](const void* pJob, uint32_t jobIdx) { (*static_cast<const Job*>(pJob))(jobIdx); }, &job);
+		}
+
+		uint32_t GetNumThreads() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+
+	private:
+		using JobFunction = void (*)(const void* pJob, uint32_t jobIdx);
+
+		void RunParallel(uint32_t jobCount, JobFunction pJobFunction, const void* pJob);
+		void WorkerLoop();
+		void RunJobs();
+
+		std::vector<std::thread> m_Workers{};
+
+		std::mutex m_Mutex{};
+		std::condition_variable m_WakeCondition{};
+		std::condition_variable m_DoneCondition{};
+
+		JobFunction m_pJobFunction{ nullptr };
+		const void* m_pJob{ nullptr };
+		uint32_t m_JobCount{};
+		std::atomic<uint32_t> m_NextJob{};
+
+		uint64_t m_Generation{};
+		uint32_t m_BusyWorkers{};
+		bool m_IsStopping{ false };
+	};
+}
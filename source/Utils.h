@@ -2,17 +2,145 @@
 #include <fstream>
 #include "Math.h"
 #include <vector>
-#include "Mesh.h"
+#include <unordered_map>
+#include "DataTypes.h"
 
 namespace dae
 {
 
 	namespace Utils
 	{
-		//Just parses vertices and indices
-#pragma warning(push)
-#pragma warning(disable : 4505) //Warning unreferenced local function
-		static bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true)
+		//One face corner of an OBJ file, 0 means the corner has no texture coordinate or normal
+		struct ObjCornerKey
+		{
+			size_t iPosition{};
+			size_t iTexCoord{};
+			size_t iNormal{};
+
+			bool operator==(const ObjCornerKey& other) const
+			{
+				return iPosition == other.iPosition && iTexCoord == other.iTexCoord && iNormal == other.iNormal;
+			}
+		};
+
+		struct ObjCornerKeyHash
+		{
+			size_t operator()(const ObjCornerKey& key) const
+			{
+				size_t hash{ std::hash<size_t>{}(key.iPosition) };
+				hash ^= std::hash<size_t>{}(key.iTexCoord) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+				hash ^= std::hash<size_t>{}(key.iNormal) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+				return hash;
+			}
+		};
+
+		//Turns the parsed pools and the face corners (three per triangle, in file winding) into an indexed mesh:
+		//corners with the same position/uv/normal triple share one vertex. False for an index outside its pool
+		inline bool BuildIndexedMesh(const std::string& filename, const std::vector<Vector3>& positions, const std::vector<Vector2>& UVs,
+			const std::vector<Vector3>& normals, const std::vector<ObjCornerKey>& corners, std::vector<Vertex>& vertices,
+			std::vector<uint32_t>& indices, bool flipAxisAndWinding, bool printStats)
+		{
+			vertices.clear();
+			indices.clear();
+			indices.reserve(corners.size());
+
+			std::unordered_map<ObjCornerKey, uint32_t, ObjCornerKeyHash> cornerToVertex{};
+			cornerToVertex.reserve(corners.size() / 2);
+
+			for (size_t iCorner = 0; iCorner + 2 < corners.size(); iCorner += 3)
+			{
+				uint32_t tempIndices[3];
+				for (size_t iFace = 0; iFace < 3; iFace++)
+				{
+					// OBJ format uses 1-based arrays, 0 is a missing texture coordinate or normal
+					const ObjCornerKey& key{ corners[iCorner + iFace] };
+					if (key.iPosition == 0 || key.iPosition > positions.size() || key.iTexCoord > UVs.size() || key.iNormal > normals.size())
+						return false;
+
+					const auto [it, isNew] { cornerToVertex.try_emplace(key, static_cast<uint32_t>(vertices.size())) };
+					if (isNew)
+					{
+						Vertex vertex{};
+						vertex.position = positions[key.iPosition - 1];
+						if (key.iTexCoord != 0)
+							vertex.uv = UVs[key.iTexCoord - 1];
+						if (key.iNormal != 0)
+							vertex.normal = normals[key.iNormal - 1];
+
+						vertices.push_back(vertex);
+					}
+					tempIndices[iFace] = it->second;
+				}
+
+				indices.push_back(tempIndices[0]);
+				if (flipAxisAndWinding) 
+				{
+					indices.push_back(tempIndices[2]);
+					indices.push_back(tempIndices[1]);
+				}
+				else
+				{
+					indices.push_back(tempIndices[1]);
+					indices.push_back(tempIndices[2]);
+				}
+			}
+
+			//Every corner used to be its own vertex, each one transformed every frame and stored in the vertex buffer
+			if (printStats)
+			{
+				const size_t savedVertices{ corners.size() - vertices.size() };
+				std::cout << filename << ": " << corners.size() << " face corners -> " << vertices.size() << " unique vertices, "
+					<< savedVertices * sizeof(Vertex) / 1024 << " KB saved";
+				if (!corners.empty())
+					std::cout << ", " << 100.0 * static_cast<double>(savedVertices) / corners.size() << "% fewer vertex transforms";
+				std::cout << "\n";
+			}
+
+			//Cheap Tangent Calculations, shared vertices sum the tangents of all their triangles
+			for (uint32_t i = 0; i < indices.size(); i += 3)
+			{
+				uint32_t index0 = indices[i];
+				uint32_t index1 = indices[size_t(i) + 1];
+				uint32_t index2 = indices[size_t(i) + 2];
+
+				const Vector3& p0 = vertices[index0].position;
+				const Vector3& p1 = vertices[index1].position;
+				const Vector3& p2 = vertices[index2].position;
+				const Vector2& uv0 = vertices[index0].uv;
+				const Vector2& uv1 = vertices[index1].uv;
+				const Vector2& uv2 = vertices[index2].uv;
+
+				const Vector3 edge0 = p1 - p0;
+				const Vector3 edge1 = p2 - p0;
+				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
+				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
+				float r = 1.f / Vector2::Cross(diffX, diffY);
+
+				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
+				vertices[index0].tangent += tangent;
+				vertices[index1].tangent += tangent;
+				vertices[index2].tangent += tangent;
+			}
+
+			//Create the Tangents (reject)
+			for (auto& v : vertices)
+			{
+				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
+
+				if(flipAxisAndWinding)
+				{
+					v.position.z *= -1.f;
+					v.normal.z *= -1.f;
+					v.tangent.z *= -1.f;
+				}
+
+			}
+
+			return true;
+		}
+
+		//Parses vertices and indices with std::ifstream, see ObjLoader for the multithreaded version
+		inline bool ParseOBJ(const std::string& filename, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, bool flipAxisAndWinding = true, bool printStats = true)
 		{
 			std::ifstream file(filename);
 			if (!file)
@@ -21,16 +149,13 @@ namespace dae
 			std::vector<Vector3> positions{};
 			std::vector<Vector3> normals{};
 			std::vector<Vector2> UVs{};
-
-			vertices.clear();
-			indices.clear();
+			std::vector<ObjCornerKey> corners{};
 
 			std::string sCommand;
-			// start a while iteration ending when the end of file is reached (ios::eof)
-			while (!file.eof())
+			//read the first word of every line, use the >> operator (istream::operator>>).
+			//Stops when no word is left, so a file ending in a face line does not parse that face twice
+			while (file >> sCommand)
 			{
-				//read the first word of the string, use the >> operator (istream::operator>>) 
-				file >> sCommand;
 				//use conditional statements to process the different commands	
 				if (sCommand == "#")
 				{
@@ -61,21 +186,12 @@ namespace dae
 				}
 				else if (sCommand == "f")
 				{
-					//if a face is read:
-					//construct the 3 vertices, add them to the vertex array
-					//add three indices to the index array
-					//add the material index as attibute to the attribute array
-					//
-					// Faces or triangles
-					Vertex vertex{};
-					size_t iPosition, iTexCoord, iNormal;
-
-					uint32_t tempIndices[3];
+					// Faces or triangles, the vertices are built from the corners once the whole file is read
 					for (size_t iFace = 0; iFace < 3; iFace++)
 					{
-						// OBJ format uses 1-based arrays
-						file >> iPosition;
-						vertex.position = positions[iPosition - 1];
+						ObjCornerKey key{};
+
+						file >> key.iPosition;
 
 						if ('/' == file.peek())//is next in buffer ==  '/' ?
 						{
@@ -84,8 +200,7 @@ namespace dae
 							if ('/' != file.peek())
 							{
 								// Optional texture coordinate
-								file >> iTexCoord;
-								vertex.uv = UVs[iTexCoord - 1];
+								file >> key.iTexCoord;
 							}
 
 							if ('/' == file.peek())
@@ -93,77 +208,20 @@ namespace dae
 								file.ignore();
 
 								// Optional vertex normal
-								file >> iNormal;
-								vertex.normal = normals[iNormal - 1];
+								file >> key.iNormal;
 							}
 						}
-
-						vertices.push_back(vertex);
-						tempIndices[iFace] = uint32_t(vertices.size()) - 1;
-						//indices.push_back(uint32_t(vertices.size()) - 1);
-					}
-
-					indices.push_back(tempIndices[0]);
-					if (flipAxisAndWinding) 
-					{
-						indices.push_back(tempIndices[2]);
-						indices.push_back(tempIndices[1]);
-					}
-					else
-					{
-						indices.push_back(tempIndices[1]);
-						indices.push_back(tempIndices[2]);
+						corners.push_back(key);
 					}
 				}
 				//read till end of line and ignore all remaining chars
 				file.ignore(1000, '\n');
 			}
 
-			//Cheap Tangent Calculations
-			for (uint32_t i = 0; i < indices.size(); i += 3)
-			{
-				uint32_t index0 = indices[i];
-				uint32_t index1 = indices[size_t(i) + 1];
-				uint32_t index2 = indices[size_t(i) + 2];
-
-				const Vector3& p0 = vertices[index0].position;
-				const Vector3& p1 = vertices[index1].position;
-				const Vector3& p2 = vertices[index2].position;
-				const Vector2& uv0 = vertices[index0].uv;
-				const Vector2& uv1 = vertices[index1].uv;
-				const Vector2& uv2 = vertices[index2].uv;
-
-				const Vector3 edge0 = p1 - p0;
-				const Vector3 edge1 = p2 - p0;
-				const Vector2 diffX = Vector2(uv1.x - uv0.x, uv2.x - uv0.x);
-				const Vector2 diffY = Vector2(uv1.y - uv0.y, uv2.y - uv0.y);
-				float r = 1.f / Vector2::Cross(diffX, diffY);
-
-				Vector3 tangent = (edge0 * diffY.y - edge1 * diffY.x) * r;
-				vertices[index0].tangent += tangent;
-				vertices[index1].tangent += tangent;
-				vertices[index2].tangent += tangent;
-			}
-
-			//Create the Tangents (reject)
-			for (auto& v : vertices)
-			{
-				v.tangent = Vector3::Reject(v.tangent, v.normal).Normalized();
-
-				if(flipAxisAndWinding)
-				{
-					v.position.z *= -1.f;
-					v.normal.z *= -1.f;
-					v.tangent.z *= -1.f;
-				}
-
-			}
-
-			return true;
+			return BuildIndexedMesh(filename, positions, UVs, normals, corners, vertices, indices, flipAxisAndWinding, printStats);
 		}
 
-#pragma warning(pop)
-		static float Remap(float depthValue, float min, float max)
+		inline float Remap(float depthValue, float min, float max)
 		{
 			const float clamped{ std::clamp(depthValue, min, max) };
 			return (clamped - min) / (max - min);
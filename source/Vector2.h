@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 
 namespace dae
 {
@@ -8,39 +11,130 @@ namespace dae
 		float y{};
 
 		Vector2() = default;
-		Vector2(float _x, float _y);
-		Vector2(const Vector2& from, const Vector2& to);
+		Vector2(float _x, float _y) : x(_x), y(_y) {}
+		Vector2(const Vector2& from, const Vector2& to) : x(to.x - from.x), y(to.y - from.y) {}
 
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector2 Normalized() const;
-		static Vector2 Min(const Vector2& v1, const Vector2& v2);
-		static Vector2 Max(const Vector2& v1, const Vector2& v2);
+		float Magnitude() const
+		{
+			return sqrtf(x * x + y * y);
+		}
 
+		float SqrMagnitude() const
+		{
+			return x * x + y * y;
+		}
 
-		static float Dot(const Vector2& v1, const Vector2& v2);
-		static float Cross(const Vector2& v1, const Vector2& v2);
+		float Normalize()
+		{
+			const float m = Magnitude();
+			x /= m;
+			y /= m;
+
+			return m;
+		}
+
+		Vector2 Normalized() const
+		{
+			const float m = Magnitude();
+			return { x / m, y / m };
+		}
+
+		static Vector2 Min(const Vector2& v1, const Vector2& v2)
+		{
+			return { std::min(v1.x, v2.x), std::min(v1.y, v2.y) };
+		}
+
+		static Vector2 Max(const Vector2& v1, const Vector2& v2)
+		{
+			return { std::max(v1.x, v2.x), std::max(v1.y, v2.y) };
+		}
+
+
+		static float Dot(const Vector2& v1, const Vector2& v2)
+		{
+			return v1.x * v2.x + v1.y * v2.y;
+		}
+
+		static float Cross(const Vector2& v1, const Vector2& v2)
+		{
+			return v1.x * v2.y - v1.y * v2.x;
+		}
 
 		//Member Operators
-		Vector2 operator*(float scale) const;
-		Vector2 operator/(float scale) const;
-		Vector2 operator+(const Vector2& v) const;
-		Vector2 operator-(const Vector2& v) const;
-		Vector2 operator-() const;
-		//Vector2& operator-();
-		Vector2& operator+=(const Vector2& v);
-		Vector2& operator-=(const Vector2& v);
-		Vector2& operator/=(float scale);
-		Vector2& operator*=(float scale);
-		float& operator[](int index);
-		float operator[](int index) const;
+		Vector2 operator*(float scale) const
+		{
+			return { x * scale, y * scale };
+		}
+
+		Vector2 operator/(float scale) const
+		{
+			return { x / scale, y / scale };
+		}
+
+		Vector2 operator+(const Vector2& v) const
+		{
+			return { x + v.x, y + v.y };
+		}
+
+		Vector2 operator-(const Vector2& v) const
+		{
+			return { x - v.x, y - v.y };
+		}
+
+		Vector2 operator-() const
+		{
+			return { -x, -y };
+		}
+
+		Vector2& operator+=(const Vector2& v)
+		{
+			x += v.x;
+			y += v.y;
+			return *this;
+		}
+
+		Vector2& operator-=(const Vector2& v)
+		{
+			x -= v.x;
+			y -= v.y;
+			return *this;
+		}
+
+		Vector2& operator/=(float scale)
+		{
+			x /= scale;
+			y /= scale;
+			return *this;
+		}
+
+		Vector2& operator*=(float scale)
+		{
+			x *= scale;
+			y *= scale;
+			return *this;
+		}
+
+		float& operator[](int index)
+		{
+			assert(index <= 1 && index >= 0);
+			return index == 0 ? x : y;
+		}
+
+		float operator[](int index) const
+		{
+			assert(index <= 1 && index >= 0);
+			return index == 0 ? x : y;
+		}
 
 		static const Vector2 UnitX;
 		static const Vector2 UnitY;
 		static const Vector2 Zero;
 	};
 
+	inline const Vector2 Vector2::UnitX{ 1, 0 };
+	inline const Vector2 Vector2::UnitY{ 0, 1 };
+	inline const Vector2 Vector2::Zero{ 0, 0 };
+
 	//Global Operators
 	inline Vector2 operator*(float scale, const Vector2& v)
 	{
@@ -1,9 +1,9 @@
 #pragma once
+#include "SimdTarget.h"
+#include "Vector3.h"
 
 namespace dae
 {
-	struct Vector2;
-	struct Vector3;
 	struct Vector4
 	{
 		float x;
@@ -12,25 +12,153 @@ namespace dae
 		float w;
 
 		Vector4() = default;
-		Vector4(float _x, float _y, float _z, float _w);
-		Vector4(const Vector3& v, float _w);
+		Vector4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+		Vector4(const Vector3& v, float _w) : x(v.x), y(v.y), z(v.z), w(_w) {}
 
-		float Magnitude() const;
-		float SqrMagnitude() const;
-		float Normalize();
-		Vector4 Normalized() const;
+		float Magnitude() const
+		{
+			return sqrtf(x * x + y * y + z * z + w * w);
+		}
 
-		Vector2 GetXY() const;
-		Vector3 GetXYZ() const;
+		float SqrMagnitude() const
+		{
+			return x * x + y * y + z * z + w * w;
+		}
 
-		static float Dot(const Vector4& v1, const Vector4& v2);
+		float Normalize()
+		{
+			const float m = Magnitude();
+			x /= m;
+			y /= m;
+			z /= m;
+			w /= m;
+
+			return m;
+		}
+
+		Vector4 Normalized() const
+		{
+			const float m = Magnitude();
+			return { x / m, y / m, z / m, w / m };
+		}
+
+		Vector2 GetXY() const
+		{
+			return { x, y };
+		}
+
+		Vector3 GetXYZ() const
+		{
+			return { x, y, z };
+		}
+
+		//Summed in order x, y, z, w: a horizontal SSE add would round differently from the scalar version
+		static float Dot(const Vector4& v1, const Vector4& v2)
+		{
+			return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z + v1.w * v2.w;
+		}
 
 		// operator overloading
 		Vector4 operator*(float scale) const;
 		Vector4 operator+(const Vector4& v) const;
 		Vector4 operator-(const Vector4& v) const;
 		Vector4& operator+=(const Vector4& v);
-		float& operator[](int index);
-		float operator[](int index) const;
+
+		float& operator[](int index)
+		{
+			assert(index <= 3 && index >= 0);
+
+			if (index == 0)return x;
+			if (index == 1)return y;
+			if (index == 2)return z;
+			return w;
+		}
+
+		float operator[](int index) const
+		{
+			assert(index <= 3 && index >= 0);
+
+			if (index == 0)return x;
+			if (index == 1)return y;
+			if (index == 2)return z;
+			return w;
+		}
 	};
+
+#if DAE_SIMD_SSE2
+	//One Vector4 per SSE register. Loads and stores are unaligned, so Vector4 keeps its 4 byte alignment
+	//and the layout of every struct that contains one stays the same
+	namespace Simd
+	{
+		inline __m128 Load(const Vector4& v)
+		{
+			return _mm_loadu_ps(&v.x);
+		}
+
+		inline Vector4 Store(__m128 v)
+		{
+			Vector4 result;
+			_mm_storeu_ps(&result.x, v);
+			return result;
+		}
+	}
+
+	inline Vector4 Vector4::operator*(float scale) const
+	{
+		return Simd::Store(_mm_mul_ps(Simd::Load(*this), _mm_set1_ps(scale)));
+	}
+
+	inline Vector4 Vector4::operator+(const Vector4& v) const
+	{
+		return Simd::Store(_mm_add_ps(Simd::Load(*this), Simd::Load(v)));
+	}
+
+	inline Vector4 Vector4::operator-(const Vector4& v) const
+	{
+		return Simd::Store(_mm_sub_ps(Simd::Load(*this), Simd::Load(v)));
+	}
+
+	inline Vector4& Vector4::operator+=(const Vector4& v)
+	{
+		*this = *this + v;
+		return *this;
+	}
+#else
+	inline Vector4 Vector4::operator*(float scale) const
+	{
+		return { x * scale, y * scale, z * scale, w * scale };
+	}
+
+	inline Vector4 Vector4::operator+(const Vector4& v) const
+	{
+		return { x + v.x, y + v.y, z + v.z, w + v.w };
+	}
+
+	inline Vector4 Vector4::operator-(const Vector4& v) const
+	{
+		return { x - v.x, y - v.y, z - v.z, w - v.w };
+	}
+
+	inline Vector4& Vector4::operator+=(const Vector4& v)
+	{
+		x += v.x;
+		y += v.y;
+		z += v.z;
+		w += v.w;
+		return *this;
+	}
+#endif
+
+	//Vector3 members that need the complete Vector4
+	inline Vector3::Vector3(const Vector4& v) : x(v.x), y(v.y), z(v.z) {}
+
+	inline Vector4 Vector3::ToPoint4() const
+	{
+		return { x, y, z, 1 };
+	}
+
+	inline Vector4 Vector3::ToVector4() const
+	{
+		return { x, y, z, 0 };
+	}
 }
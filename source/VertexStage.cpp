@@ -0,0 +1,194 @@
+#include "pch.h"
+#include "VertexStage.h"
+#include "SimdTarget.h"
+#include "ThreadPool.h"
+
+namespace dae
+{
+	void VertexStreams::FillBlock(std::span<const Vertex> vertices, std::span<float> block)
+	{
+		const size_t padded{ GetPaddedCount(vertices.size()) };
+		std::fill(block.begin(), block.end(), 0.f);
+
+		for (size_t i{}; i < vertices.size(); ++i)
+		{
+			const Vertex& vertex{ vertices[i] };
+			const float components[STREAM_COUNT]{ vertex.position.x, vertex.position.y, vertex.position.z,
+				vertex.normal.x, vertex.normal.y, vertex.normal.z, vertex.tangent.x, vertex.tangent.y, vertex.tangent.z };
+			for (size_t stream{}; stream < STREAM_COUNT; ++stream)
+				block[stream * padded + i] = components[stream];
+		}
+	}
+
+	void VertexStreams::Build(std::span<const Vertex> vertices)
+	{
+		m_Block.resize(GetBlockSize(vertices.size()));
+		FillBlock(vertices, m_Block);
+		Attach(vertices.size(), m_Block.data());
+	}
+
+	void VertexStreams::Attach(size_t count, const float* pBlock)
+	{
+		vertexCount = count;
+		paddedCount = GetPaddedCount(count);
+
+		std::span<const float>* pStreams[STREAM_COUNT]{ &positionX, &positionY, &positionZ, &normalX, &normalY, &normalZ, &tangentX, &tangentY, &tangentZ };
+		for (size_t stream{}; stream < STREAM_COUNT; ++stream)
+			*pStreams[stream] = { pBlock + stream * paddedCount, paddedCount };
+	}
+
+	namespace VertexStage
+	{
+		namespace
+		{
+			//Below this the whole mesh is transformed on the calling thread, waking the pool would cost more than it saves
+			constexpr size_t MIN_PARALLEL_VERTICES{ 16 * 1024 };
+			constexpr size_t VERTICES_PER_JOB{ 4 * 1024 };
+			static_assert(VERTICES_PER_JOB % VertexStreams::LANE_COUNT == 0, "Jobs have to start on a full batch");
+
+			//Same operations in the same order as the AVX2 version, so both produce identical vertices
+			void TransformScalar(const VertexStreams& streams, std::span<const Vertex> vertices,
+				const Matrix& worldViewProjection, const Matrix& world, size_t begin, size_t end, Vertex_Out* pVerticesOut)
+			{
+				for (size_t i{ begin }; i < end; ++i)
+				{
+					Vertex_Out& vertexOut{ pVerticesOut[i] };
+					vertexOut.position = worldViewProjection.TransformPoint(Vector4{ streams.positionX[i], streams.positionY[i], streams.positionZ[i], 1 });
+					vertexOut.color = vertices[i].color;
+					vertexOut.uv = vertices[i].uv;
+
+					//The position stays in clip space, the perspective divide happens after clipping
+					const Vector3 projectedPosition{ vertexOut.position.x / vertexOut.position.w, vertexOut.position.y / vertexOut.position.w, vertexOut.position.z / vertexOut.position.w };
+					vertexOut.viewDirection = projectedPosition.Normalized();
+
+					vertexOut.normal = world.TransformVector(streams.normalX[i], streams.normalY[i], streams.normalZ[i]).Normalized();
+					vertexOut.tangent = world.TransformVector(streams.tangentX[i], streams.tangentY[i], streams.tangentZ[i]).Normalized();
+				}
+			}
+
+#if DAE_SIMD_X86
+			//Column c of a matrix broadcast to all lanes: the coefficients of output component c
+			struct Column
+			{
+				__m256 x, y, z, w;
+			};
+
+			DAE_TARGET_AVX2 Column BroadcastColumn(const Matrix& matrix, int c)
+			{
+				return Column{ _mm256_set1_ps(matrix[0][c]), _mm256_set1_ps(matrix[1][c]), _mm256_set1_ps(matrix[2][c]), _mm256_set1_ps(matrix[3][c]) };
+			}
+
+			struct Vector3x8
+			{
+				__m256 x, y, z;
+			};
+
+			DAE_TARGET_AVX2 Vector3x8 Normalize(const Vector3x8& v)
+			{
+				const __m256 magnitude{ _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(v.x, v.x), _mm256_mul_ps(v.y, v.y)), _mm256_mul_ps(v.z, v.z))) };
+				return Vector3x8{ _mm256_div_ps(v.x, magnitude), _mm256_div_ps(v.y, magnitude), _mm256_div_ps(v.z, magnitude) };
+			}
+
+			//Matrix::TransformVector on eight vectors, the translation row is ignored
+			DAE_TARGET_AVX2 __m256 TransformComponent(const Column& column, __m256 x, __m256 y, __m256 z)
+			{
+				return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(column.x, x), _mm256_mul_ps(column.y, y)), _mm256_mul_ps(column.z, z));
+			}
+
+			DAE_TARGET_AVX2 Vector3x8 TransformVector(const Column columns[3], const float* pX, const float* pY, const float* pZ)
+			{
+				const __m256 x{ _mm256_loadu_ps(pX) };
+				const __m256 y{ _mm256_loadu_ps(pY) };
+				const __m256 z{ _mm256_loadu_ps(pZ) };
+				return Vector3x8{ TransformComponent(columns[0], x, y, z), TransformComponent(columns[1], x, y, z), TransformComponent(columns[2], x, y, z) };
+			}
+
+			DAE_TARGET_AVX2 void TransformAVX2(const VertexStreams& streams, std::span<const Vertex> vertices,
+				const Matrix& worldViewProjection, const Matrix& world, size_t begin, size_t end, Vertex_Out* pVerticesOut)
+			{
+				constexpr size_t laneCount{ VertexStreams::LANE_COUNT };
+				Column clipColumns[4];
+				for (int c = 0; c < 4; ++c)
+					clipColumns[c] = BroadcastColumn(worldViewProjection, c);
+				const Column worldColumns[3]{ BroadcastColumn(world, 0), BroadcastColumn(world, 1), BroadcastColumn(world, 2) };
+
+				//Results of one batch, scattered into the AoS output the clipper and rasterizer read
+				alignas(32) float position[4][laneCount];
+				alignas(32) float viewDirection[3][laneCount];
+				alignas(32) float normal[3][laneCount];
+				alignas(32) float tangent[3][laneCount];
+
+				for (size_t first{ begin }; first < end; first += laneCount)
+				{
+					//Padded lanes past the last vertex compute garbage that is never written out
+					const __m256 x{ _mm256_loadu_ps(streams.positionX.data() + first) };
+					const __m256 y{ _mm256_loadu_ps(streams.positionY.data() + first) };
+					const __m256 z{ _mm256_loadu_ps(streams.positionZ.data() + first) };
+
+					__m256 clip[4];
+					for (int c = 0; c < 4; ++c)
+					{
+						//w = 1, so the translation row is added as is
+						clip[c] = _mm256_add_ps(TransformComponent(clipColumns[c], x, y, z), clipColumns[c].w);
+						_mm256_store_ps(position[c], clip[c]);
+					}
+
+					const Vector3x8 view{ Normalize(Vector3x8{ _mm256_div_ps(clip[0], clip[3]), _mm256_div_ps(clip[1], clip[3]), _mm256_div_ps(clip[2], clip[3]) }) };
+					_mm256_store_ps(viewDirection[0], view.x);
+					_mm256_store_ps(viewDirection[1], view.y);
+					_mm256_store_ps(viewDirection[2], view.z);
+
+					const Vector3x8 worldNormal{ Normalize(TransformVector(worldColumns, streams.normalX.data() + first, streams.normalY.data() + first, streams.normalZ.data() + first)) };
+					_mm256_store_ps(normal[0], worldNormal.x);
+					_mm256_store_ps(normal[1], worldNormal.y);
+					_mm256_store_ps(normal[2], worldNormal.z);
+
+					const Vector3x8 worldTangent{ Normalize(TransformVector(worldColumns, streams.tangentX.data() + first, streams.tangentY.data() + first, streams.tangentZ.data() + first)) };
+					_mm256_store_ps(tangent[0], worldTangent.x);
+					_mm256_store_ps(tangent[1], worldTangent.y);
+					_mm256_store_ps(tangent[2], worldTangent.z);
+
+					const size_t batchSize{ std::min(laneCount, end - first) };
+					for (size_t lane{}; lane < batchSize; ++lane)
+					{
+						Vertex_Out& vertexOut{ pVerticesOut[first + lane] };
+						vertexOut.position = Vector4{ position[0][lane], position[1][lane], position[2][lane], position[3][lane] };
+						vertexOut.color = vertices[first + lane].color;
+						vertexOut.uv = vertices[first + lane].uv;
+						vertexOut.normal = Vector3{ normal[0][lane], normal[1][lane], normal[2][lane] };
+						vertexOut.tangent = Vector3{ tangent[0][lane], tangent[1][lane], tangent[2][lane] };
+						vertexOut.viewDirection = Vector3{ viewDirection[0][lane], viewDirection[1][lane], viewDirection[2][lane] };
+					}
+				}
+			}
+#endif
+		}
+
+		TransformFunction GetTransformFunction(RasterKernels::KernelType type)
+		{
+#if DAE_SIMD_X86
+			if (type == RasterKernels::KernelType::AVX2)
+				return TransformAVX2;
+#endif
+			return TransformScalar;
+		}
+
+		void TransformVertices(TransformFunction transform, const VertexStreams& streams, std::span<const Vertex> vertices,
+			const Matrix& worldViewProjection, const Matrix& world, Vertex_Out* pVerticesOut, ThreadPool& threadPool)
+		{
+			const size_t vertexCount{ streams.vertexCount };
+			if (vertexCount < MIN_PARALLEL_VERTICES)
+			{
+				transform(streams, vertices, worldViewProjection, world, 0, vertexCount, pVerticesOut);
+				return;
+			}
+
+			const uint32_t jobCount{ static_cast<uint32_t>((vertexCount + VERTICES_PER_JOB - 1) / VERTICES_PER_JOB) };
+			threadPool.ParallelFor(jobCount, [&](uint32_t jobIdx)
+				{
+					const size_t begin{ jobIdx * VERTICES_PER_JOB };
+					transform(streams, vertices, worldViewProjection, world, begin, std::min(begin + VERTICES_PER_JOB, vertexCount), pVerticesOut);
+				});
+		}
+	}
+}
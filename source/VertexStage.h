@@ -0,0 +1,69 @@
+#pragma once
+#include "DataTypes.h"
+#include "RasterKernels.h"
+
+//Standard includes
+#include <span>
+#include <vector>
+
+namespace dae
+{
+	class ThreadPool;
+
+	//The vertex attributes the software vertex stage transforms, one array per component
+	//so eight vertices load with one instruction per component
+	struct VertexStreams
+	{
+		static constexpr size_t LANE_COUNT{ 8 };
+		static constexpr size_t STREAM_COUNT{ 9 };
+
+		size_t vertexCount{};
+		//vertexCount rounded up to a multiple of LANE_COUNT, the padding is zero
+		size_t paddedCount{};
+
+		//paddedCount floats each, views into the owned block or into a mapped mesh cache
+		std::span<const float> positionX{}, positionY{}, positionZ{};
+		std::span<const float> normalX{}, normalY{}, normalZ{};
+		std::span<const float> tangentX{}, tangentY{}, tangentZ{};
+
+		VertexStreams() = default;
+		~VertexStreams() = default;
+
+		//The views point into m_Block, a copy would point into the original
+		VertexStreams(const VertexStreams&) = delete;
+		VertexStreams(VertexStreams&&) noexcept = default;
+		VertexStreams& operator=(const VertexStreams&) = delete;
+		VertexStreams& operator=(VertexStreams&&) noexcept = default;
+
+		static size_t GetPaddedCount(size_t vertexCount) { return (vertexCount + LANE_COUNT - 1) / LANE_COUNT * LANE_COUNT; }
+		//Floats of the block that holds all streams back to back, in the order they are declared
+		static size_t GetBlockSize(size_t vertexCount) { return STREAM_COUNT * GetPaddedCount(vertexCount); }
+		//Fills such a block, GetBlockSize(vertices.size()) floats. The mesh cache stores it as is
+		static void FillBlock(std::span<const Vertex> vertices, std::span<float> block);
+
+		//Copies the attributes of vertices into a block of its own
+		void Build(std::span<const Vertex> vertices);
+		//Views a block FillBlock wrote, which has to outlive the streams
+		void Attach(size_t count, const float* pBlock);
+
+	private:
+		std::vector<float> m_Block{};
+	};
+
+	namespace VertexStage
+	{
+		//Transforms vertices [begin, end) into pVerticesOut[begin, end), begin has to be a multiple of LANE_COUNT.
+		//Positions end up in clip space, normals and tangents in world space and normalized,
+		//color and uv are copied from vertices. The tangent has to rotate with the normal like in MeshShader.fx,
+		//otherwise the tangent frame PixelShading builds from them skews as soon as the mesh turns
+		using TransformFunction = void(*)(const VertexStreams& streams, std::span<const Vertex> vertices,
+			const Matrix& worldViewProjection, const Matrix& world, size_t begin, size_t end, Vertex_Out* pVerticesOut);
+
+		//The AVX2 version for KernelType::AVX2, the scalar one otherwise
+		TransformFunction GetTransformFunction(RasterKernels::KernelType type);
+
+		//Runs transform over all vertices, split over the pool once the mesh is big enough to be worth the threads
+		void TransformVertices(TransformFunction transform, const VertexStreams& streams, std::span<const Vertex> vertices,
+			const Matrix& worldViewProjection, const Matrix& world, Vertex_Out* pVerticesOut, ThreadPool& threadPool);
+	}
+}
@@ -7,6 +7,12 @@
 #undef main
 #include "Renderer.h"
 
+//Standard includes
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
 using namespace dae;
 
 void ShutDown(SDL_Window* pWindow)
@@ -15,11 +21,91 @@ void ShutDown(SDL_Window* pWindow)
 	SDL_Quit();
 }
 
+//Software frames without a window: --headless WIDTHxHEIGHT [--frames N] [--capture out.ppm|out.png] [--no-rotation]
+struct HeadlessOptions
+{
+	bool isEnabled{ false };
+	int width{ 640 };
+	int height{ 480 };
+	int frames{ 100 };
+	std::string capturePath{};
+	bool isRotating{ true };
+};
+
+bool ParseHeadlessOptions(int argc, char* args[], HeadlessOptions& options)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg{ args[i] };
+		const bool hasValue{ i + 1 < argc };
+		if (arg == "--headless" && hasValue)
+		{
+			options.isEnabled = true;
+			if (std::sscanf(args[++i], "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 || options.height <= 0)
+			{
+				std::cout << "Expected --headless WIDTHxHEIGHT, got " << args[i] << "\n";
+				return false;
+			}
+		}
+		else if (arg == "--frames" && hasValue)
+			options.frames = std::max(std::atoi(args[++i]), 1);
+		else if (arg == "--capture" && hasValue)
+			options.capturePath = args[++i];
+		else if (arg == "--no-rotation")
+			options.isRotating = false;
+		else
+		{
+			std::cout << "Unknown argument " << arg << "\n";
+			return false;
+		}
+	}
+	return true;
+}
+
+//Waits for every asset so all frames draw the same scene, then renders, reports and captures the last frame
+int RunHeadless(const HeadlessOptions& options)
+{
+	const auto pTimer = new Timer();
+	const auto pRenderer = new Renderer(options.width, options.height);
+	pRenderer->WaitForAssets();
+	if (!options.isRotating)
+		pRenderer->ToggleRotation();
+
+	pTimer->Start();
+	const auto renderStart{ std::chrono::steady_clock::now() };
+	for (int frame = 0; frame < options.frames; ++frame)
+	{
+		pRenderer->Update(pTimer);
+		pRenderer->Render();
+		pTimer->Update();
+	}
+	const double renderMs{ std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - renderStart).count() };
+	pTimer->Stop();
+
+	std::cout << options.frames << " frames at " << options.width << "x" << options.height << ", average " << renderMs / options.frames << " ms\n";
+	pRenderer->PrintFrameStats();
+
+	const bool isCaptured{ options.capturePath.empty() || pRenderer->CaptureFrame(options.capturePath) };
+
+	delete pRenderer;
+	delete pTimer;
+
+	SDL_Quit();
+	return isCaptured ? 0 : 1;
+}
+
 int main(int argc, char* args[])
 {
-	//Unreferenced parameters
-	(void)argc;
-	(void)args;
+	HeadlessOptions headlessOptions{};
+	if (!ParseHeadlessOptions(argc, args, headlessOptions))
+		return 1;
+
+	//No video subsystem at all, so this runs on machines without a display
+	if (headlessOptions.isEnabled)
+	{
+		SDL_Init(0);
+		return RunHeadless(headlessOptions);
+	}
 
 	//Create window + surfaces
 	SDL_Init(SDL_INIT_VIDEO);
@@ -71,6 +157,8 @@ int main(int argc, char* args[])
 				{
 					if (pRenderer->GetSystemMode() == SystemMode::Hardware)
 						pRenderer->SwitchTechnique();
+					else
+						pRenderer->SwitchTextureFilter();
 				}
 				if (e.key.keysym.scancode == SDL_SCANCODE_F5) //Done
 				{
@@ -100,6 +188,36 @@ int main(int argc, char* args[])
 				{
 					pTimer->ToggleShowFPS();
 				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_F12)
+				{
+					if (pRenderer->GetSystemMode() == SystemMode::Software)
+						pRenderer->ToggleTiledRendering();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_K)
+				{
+					if (pRenderer->GetSystemMode() == SystemMode::Software)
+						pRenderer->ToggleSimdKernel();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_H)
+				{
+					if (pRenderer->GetSystemMode() == SystemMode::Software)
+						pRenderer->ToggleHiZ();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_V)
+				{
+					if (pRenderer->GetSystemMode() == SystemMode::Software)
+						pRenderer->ToggleVisibilityBuffer();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_T)
+				{
+					if (pRenderer->GetSystemMode() == SystemMode::Software)
+						pRenderer->ToggleTexelLayout();
+				}
+				if (e.key.keysym.scancode == SDL_SCANCODE_B)
+				{
+					if (pRenderer->GetSystemMode() == SystemMode::Software)
+						pRenderer->RequestBenchmark();
+				}
 				break;
 			default: ;
 			}
@@ -120,6 +238,8 @@ int main(int argc, char* args[])
 			{
 				printTimer = 0.f;
 				std::cout << "dFPS: " << pTimer->GetdFPS() << std::endl;
+				if (pRenderer->GetSystemMode() == SystemMode::Software)
+					pRenderer->PrintFrameStats();
 			}
 		}
 	}
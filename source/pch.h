@@ -5,8 +5,11 @@
 #include <algorithm>
 #include <sstream>
 #include <memory>
+#include <bit>
 #define NOMINMAX  //for directx
 
+//The portable software rasterizer library (see CMakeLists.txt) builds without SDL and DirectX
+#ifndef DAE_SOFTWARE_ONLY
 // SDL Headers
 #include "SDL.h"
 #include "SDL_syswm.h"
@@ -22,6 +25,7 @@
 
 // Framework Headers
 #include "Timer.h"
+#endif
 #include "Math.h"
 
 //Additional Headers
@@ -0,0 +1,98 @@
+#include "pch.h"
+#include "AllocationCounter.h"
+#include "SoftwareBackend.h"
+#include "Mesh.h"
+
+//Standard includes
+#include <memory>
+#include <vector>
+
+using namespace dae;
+
+namespace
+{
+	constexpr int WIDTH{ 640 };
+	constexpr int HEIGHT{ 480 };
+	//Frames that let every buffer grow to its steady state size, then the frames that may not allocate at all
+	constexpr int WARM_UP_FRAMES{ 3 };
+	constexpr int MEASURED_FRAMES{ 5 };
+
+	int g_FailureCount{};
+
+	void Check(bool isPassed, const char* name, uint64_t value)
+	{
+		std::cout << (isPassed ? "PASS " : "FAIL ") << name << ": " << value << "\n";
+		if (!isPassed)
+			++g_FailureCount;
+	}
+
+	//Ground plane of quadCount x quadCount quads below the camera, reaching behind it so the near plane clips it
+	Mesh* CreateGroundMesh(int quadCount)
+	{
+		constexpr float size{ 100.f };
+		const float step{ size / quadCount };
+
+		std::vector<Vertex> vertices{};
+		for (int z{}; z <= quadCount; ++z)
+		{
+			for (int x{}; x <= quadCount; ++x)
+			{
+				Vertex vertex{};
+				vertex.position = { -size * 0.5f + x * step, -2.f, -size * 0.1f + z * step };
+				vertex.uv = { static_cast<float>(x) / quadCount, static_cast<float>(z) / quadCount };
+				vertex.normal = { 0.f, 1.f, 0.f };
+				vertex.tangent = { 1.f, 0.f, 0.f };
+				vertices.push_back(vertex);
+			}
+		}
+
+		std::vector<uint32_t> indices{};
+		const uint32_t rowSize{ static_cast<uint32_t>(quadCount + 1) };
+		for (uint32_t z{}; z < static_cast<uint32_t>(quadCount); ++z)
+		{
+			for (uint32_t x{}; x < static_cast<uint32_t>(quadCount); ++x)
+			{
+				const uint32_t corner{ x + z * rowSize };
+				indices.insert(indices.end(), { corner, corner + rowSize, corner + 1, corner + 1, corner + rowSize, corner + rowSize + 1 });
+			}
+		}
+		return new Mesh(std::move(vertices), std::move(indices));
+	}
+}
+
+//Renders the same software frame over and over: once the first frames have grown every buffer,
+//a frame may not go to the heap at all. Needs DAE_COUNT_ALLOCATIONS, see tests/CMakeLists.txt
+int main()
+{
+	static_assert(AllocationCounter::IS_ENABLED, "The allocation tests count through the replaced operator new");
+
+	//The test is worthless when the counter does not see allocations
+	const uint64_t countBeforeNew{ AllocationCounter::GetCount() };
+	const std::unique_ptr<int> pProbe{ std::make_unique<int>(0) };
+	Check(AllocationCounter::GetCount() - countBeforeNew == 1, "allocations counted for one new", AllocationCounter::GetCount() - countBeforeNew);
+
+	MemoryFrameTarget frameTarget{ WIDTH, HEIGHT };
+	SoftwareBackend backend{ WIDTH, HEIGHT, &frameTarget };
+
+	const std::unique_ptr<Mesh> pMesh{ CreateGroundMesh(64) };
+	const std::unique_ptr<Texture> pTexture{ Texture::CreateSolidColor(128, 128, 128, 255) };
+	const std::unique_ptr<Texture> pNormalTexture{ Texture::CreateSolidColor(128, 128, 255, 255) };
+
+	Scene scene{};
+	scene.projectionMatrix = Matrix::CreatePerspectiveFovLH(std::tan(45.f * TO_RADIANS * 0.5f), static_cast<float>(WIDTH) / HEIGHT, 0.1f, 100.f);
+	scene.opaque.pMesh = pMesh.get();
+	scene.opaque.material = Material{ pTexture.get(), pNormalTexture.get(), pTexture.get(), pTexture.get() };
+
+	for (int frame{}; frame < WARM_UP_FRAMES; ++frame)
+		backend.Render(scene);
+
+	const uint64_t countBeforeFrames{ AllocationCounter::GetCount() };
+	for (int frame{}; frame < MEASURED_FRAMES; ++frame)
+		backend.Render(scene);
+	const uint64_t frameAllocations{ AllocationCounter::GetCount() - countBeforeFrames };
+
+	backend.PrintFrameStats();
+	Check(frameAllocations == 0, "heap allocations in the steady state frames", frameAllocations);
+
+	return g_FailureCount == 0 ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include "pch.h"
+#include "MathReference.h"
+
+//Standard includes
+#include <vector>
+
+using namespace dae;
+
+namespace
+{
+	constexpr size_t INPUT_COUNT{ 64 * 1024 };
+	//|M * Inverse(M) - I| on MathReference::RandomMatrix inputs, measured around 1e-4
+	constexpr float MAX_INVERSE_RESIDUAL{ 1e-3f };
+	//|cos| between Cross(a, b) and a, measured around 4e-6
+	constexpr float MAX_CROSS_COSINE{ 1e-4f };
+
+	int g_FailureCount{};
+
+	void Check(bool isPassed, const char* name, float value)
+	{
+		std::cout << (isPassed ? "PASS " : "FAIL ") << name << ": " << value << "\n";
+		if (!isPassed)
+			++g_FailureCount;
+	}
+}
+
+//The header-only Vector/Matrix code against the scalar reference on random inputs. Both do the same float
+//operations in the same order, so everything but Inverse and Cross has to be bit-identical
+int main()
+{
+	std::mt19937 generator{ 21 };
+	std::uniform_real_distribution<float> coordinate{ -100.f, 100.f };
+
+	std::vector<Matrix> matrices(INPUT_COUNT);
+	std::vector<Vector4> points(INPUT_COUNT);
+	std::vector<Vector3> vectors(INPUT_COUNT);
+	for (size_t i{}; i < INPUT_COUNT; ++i)
+	{
+		matrices[i] = MathReference::RandomMatrix(generator);
+		points[i] = { coordinate(generator), coordinate(generator), coordinate(generator), 1.f };
+		vectors[i] = { coordinate(generator), coordinate(generator), coordinate(generator) };
+	}
+
+	float multiplyDifference{}, pointDifference{}, vectorDifference{}, inverseResidual{}, crossCosine{};
+	for (size_t i{}; i < INPUT_COUNT; ++i)
+	{
+		//Every input against its neighbour, wrapping around
+		const size_t next{ (i + 1) % INPUT_COUNT };
+		const Matrix& m{ matrices[i] };
+
+		multiplyDifference = std::max(multiplyDifference, MathReference::MaxDifference(m * matrices[next], MathReference::Multiply(m, matrices[next])));
+		pointDifference = std::max(pointDifference, MathReference::MaxDifference(m.TransformPoint(points[i]), MathReference::TransformPoint(m, points[i])));
+		vectorDifference = std::max(vectorDifference, MathReference::MaxDifference(m.TransformVector(vectors[i]).Normalized().ToVector4(),
+			MathReference::TransformVector(m, vectors[i]).Normalized().ToVector4()));
+		inverseResidual = std::max(inverseResidual, MathReference::MaxDifference(m * Matrix::Inverse(m), Matrix{}));
+
+		const Vector3 cross{ Vector3::Cross(vectors[i], vectors[next]) };
+		crossCosine = std::max(crossCosine, std::abs(Vector3::Dot(cross, vectors[i])) / (cross.Magnitude() * vectors[i].Magnitude()));
+	}
+
+	std::cout << "Math library against the scalar reference, " << INPUT_COUNT << " random inputs, "
+		<< (DAE_SIMD_SSE2 ? "SSE2" : "scalar") << " build\n";
+	Check(multiplyDifference == 0.f, "Matrix * Matrix, max difference", multiplyDifference);
+	Check(pointDifference == 0.f, "TransformPoint(Vector4), max difference", pointDifference);
+	Check(vectorDifference == 0.f, "TransformVector + Normalized, max difference", vectorDifference);
+	Check(inverseResidual <= MAX_INVERSE_RESIDUAL, "max |M * Inverse(M) - I|", inverseResidual);
+	Check(crossCosine <= MAX_CROSS_COSINE, "max |cos| between Cross(a, b) and a", crossCosine);
+
+	return g_FailureCount == 0 ? 0 : 1;
+}